@@ -24,6 +24,21 @@
 
 #include "util/asyncDelay.h"
 #include "util/dinDebounce.h"
+#include "util/dinBank.h"
+
+#ifndef IIKIT_DIN_INTERRUPT
+/**
+ * @brief Modo de leitura dos quatro botões do kit.
+ *
+ * 0 (padrão): os botões são filtrados juntos pelo DinBank_c inputs, com uma leitura de
+ * registrador por tick e custo fixo no loop, mas um pulso só é visto se o loop amostrar o
+ * pino durante quatro ticks seguidos. 1: cada botão usa sua interrupção de GPIO
+ * (DigitalINDebounce::enableInterrupt()), que registra as bordas com o instante e reconhece
+ * pulsos mais curtos que uma volta lenta do loop, ao custo de uma ISR por borda e de um
+ * update() por botão.
+ */
+#define IIKIT_DIN_INTERRUPT 0
+#endif
 
 /********** GPIO DEFINITIONS ***********/
 #define def_pin_ADC1 39    ///< GPIO para entrada ADC1. ADC1_CHANNEL_3
@@ -61,6 +76,7 @@ private:
     char DDNSName[15] = "iikit"; ///< Nome do dispositivo para mDNS.
     WiFiManager wm;               ///< Gerenciador de conexões Wi-Fi.
     ADS1115_c ads;                  ///< Conversor ADC.
+    uint64_t changedInputs = 0;     ///< Máscara retornada pelo último inputs.update().
 
     /**
      * @brief Exibe mensagens de erro e reinicia o dispositivo se necessário.
@@ -74,6 +90,7 @@ public:
     DigitalINDebounce  rtn_2;       ///< Botão de retorno 2.
     DigitalINDebounce  push_1;      ///< Botão push 1.
     DigitalINDebounce  push_2;      ///< Botão push 2.
+    DinBank_c inputs;               ///< Debounce conjunto das entradas do kit (os botões só com IIKIT_DIN_INTERRUPT 0).
     Display_c disp;    ///< Display OLED.
 
     /**
@@ -86,6 +103,15 @@ public:
      */
     void loop(void);
 
+    /**
+     * @brief Pinos cujo estado filtrado mudou na última chamada de loop().
+     *
+     * loop() já chama inputs.update(); uma segunda chamada no sketch quase sempre retorna 0
+     * (o tick ainda não venceu) e perderia as bordas, então use esta máscara.
+     * @return Máscara de bits por GPIO (0 se nada mudou).
+     */
+    uint64_t inputsChanged(void);
+
     /**
      * @brief Lê o valor do potenciômetro 1.
      * @return Valor analógico do potenciômetro 1.
@@ -125,6 +151,7 @@ void IIKit_c::setup()
         disp.setText(1, "Inicializando...");
         disp.setText(2, "WIFI not connected");
         disp.setText(3, "Starting Access Point Mode");
+        disp.startRenderer();
     }
     delay(50);
     /****** Inicializando WIFI ***********/
@@ -170,6 +197,19 @@ void IIKit_c::setup()
     rtn_2.setup(def_pin_RTN2, 50);
     push_1.setup(def_pin_PUSH1, 50);
     push_2.setup(def_pin_PUSH2, 50);
+#if IIKIT_DIN_INTERRUPT
+    rtn_1.enableInterrupt();
+    rtn_2.enableInterrupt();
+    push_1.enableInterrupt();
+    push_2.enableInterrupt();
+#else
+    // Os quatro botões são filtrados juntos pelo banco, que repassa o estado a cada objeto.
+    DinBank_c::CallbackFunc feed = [](void *ctx, bool v) { ((DigitalINDebounce *)ctx)->setStableState(v); };
+    inputs.watch(def_pin_RTN1, feed, &rtn_1);
+    inputs.watch(def_pin_RTN2, feed, &rtn_2);
+    inputs.watch(def_pin_PUSH1, feed, &push_1);
+    inputs.watch(def_pin_PUSH2, feed, &push_2);
+#endif
 
     digitalWrite(def_pin_D1, LOW);
     digitalWrite(def_pin_D2, LOW);        
@@ -188,10 +228,18 @@ void IIKit_c::loop(void)
     ArduinoOTA.handle();
     wserial::loop();
     updateDisplay(&disp);
+#if IIKIT_DIN_INTERRUPT
     rtn_1.update();
     rtn_2.update();
     push_1.update();
     push_2.update();
+#endif
+    changedInputs = inputs.update();
+}
+
+uint64_t IIKit_c::inputsChanged(void)
+{
+    return changedInputs;
 }
 
 uint16_t IIKit_c::analogReadPot1(void)
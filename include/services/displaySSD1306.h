@@ -0,0 +1,105 @@
+#ifndef __DISPLAYSSD1306_H
+#define __DISPLAYSSD1306_H
+
+/**
+ * @file displaySSD1306.h
+ * @brief Ligação de Display_c ao SSD1306 por I2C (Wire + Adafruit_SSD1306).
+ *
+ * Contém o objeto global SSD1306, o envio por janelas de página/coluna (ssd1306WriteRegion),
+ * o backend FbSSD1306_c e o rasterizador ssd1306Rasterize(), que desenha o texto com o
+ * Adafruit_GFX num GFXcanvas1 (mesmos pixels de sempre no display). display_c.h só inclui
+ * este arquivo quando DISPLAY_SSD1306 é 1 (padrão no Arduino).
+ */
+
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include "../util/fbBackend.h"
+
+#define SCREEN_ADDRESS 0x3C ///< Endereço I2C do display OLED.
+#define SCREEN_WIDTH 128    ///< Largura do display em pixels.
+#define SCREEN_HEIGHT 64    ///< Altura do display em pixels.
+#define OLED_RESET -1       ///< Pino de reset (ou -1 para compartilhar com o reset do Arduino).
+#define SSD1306_WIRE_CLOCK 400000UL   ///< Clock do I2C durante o envio (como no Adafruit_SSD1306).
+#define SSD1306_WIRE_RESTORE 100000UL ///< Clock do I2C restaurado após o envio.
+#ifdef I2C_BUFFER_LENGTH
+#define SSD1306_WIRE_CHUNK (I2C_BUFFER_LENGTH - 1) ///< Bytes de dados por transmissão I2C.
+#else
+#define SSD1306_WIRE_CHUNK 31
+#endif
+
+static_assert(SCREEN_WIDTH == FB_WIDTH && SCREEN_HEIGHT == FB_HEIGHT, "fbDirty.h deve ter as dimensoes do display");
+
+Adafruit_SSD1306 SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+
+/**
+ * @brief Envia uma janela do framebuffer ao SSD1306 (páginas page0..page1, colunas x0..x1).
+ * @param fb Framebuffer completo, organizado em páginas (fb[x + página * SCREEN_WIDTH]).
+ */
+inline void ssd1306WriteRegion(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) {
+    Wire.setClock(SSD1306_WIRE_CLOCK);
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    Wire.write((uint8_t)0x00); // comandos
+    Wire.write((uint8_t)SSD1306_PAGEADDR);
+    Wire.write(page0);
+    Wire.write(page1);
+    Wire.write((uint8_t)SSD1306_COLUMNADDR);
+    Wire.write(x0);
+    Wire.write(x1);
+    Wire.endTransmission();
+    uint8_t room = 0;
+    for (uint8_t p = page0; p <= page1; p++) {
+        const uint8_t *row = fb + p * SCREEN_WIDTH;
+        for (uint16_t x = x0; x <= x1; x++) {
+            if (!room) {
+                Wire.beginTransmission(SCREEN_ADDRESS);
+                Wire.write((uint8_t)0x40); // dados
+                room = SSD1306_WIRE_CHUNK;
+            }
+            Wire.write(row[x]);
+            if (!--room) Wire.endTransmission();
+        }
+    }
+    if (room) Wire.endTransmission();
+    Wire.setClock(SSD1306_WIRE_RESTORE);
+}
+
+/**
+ * @brief Rasteriza texto com o Adafruit_GFX (fonte cp437) no formato de fbRasterizer_t.
+ * @return false se o GFXcanvas1 não pôde ser alocado.
+ */
+inline bool ssd1306Rasterize(uint8_t *rows, uint16_t w, uint8_t h, int16_t x, const char *text, uint8_t size) {
+    GFXcanvas1 canvas(w, h);
+    if (!canvas.getBuffer()) return false;
+    canvas.setTextWrap(false);
+    canvas.cp437(true);
+    canvas.setTextSize(size);
+    canvas.setTextColor(SSD1306_WHITE);
+    canvas.setCursor(x, 0);
+    canvas.print(text);
+    memcpy(rows, canvas.getBuffer(), (size_t)((w + 7) / 8) * h);
+    return true;
+}
+
+/**
+ * @class FbSSD1306_c
+ * @brief Backend do SSD1306 por I2C (objeto global SSD1306).
+ */
+class FbSSD1306_c : public FbBackend_c {
+public:
+    bool begin() override {
+        return SSD1306.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS);
+    }
+
+    uint8_t *buffer() override {
+        return SSD1306.getBuffer();
+    }
+
+protected:
+    void writeRegion(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) override {
+        ssd1306WriteRegion(page0, page1, x0, x1, fb);
+    }
+};
+
+FbSSD1306_c ssd1306Backend; ///< Backend padrão de Display_c.
+
+#endif
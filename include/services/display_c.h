@@ -7,30 +7,36 @@
  *
  * Esta classe encapsula o funcionamento de displays OLED, fornecendo funcionalidades
  * para inicialização, atualização e configuração de texto com suporte a rolagem e modos de função.
+ *
+ * Todo o desenho (linhas alteradas, rolagem por tempo, faixas em cache, gráfico de tendência,
+ * envio em segundo plano e medidas) fica em FbScreen_c (util/fbScreen.h), que só depende de um
+ * FbBackend_c. Display_c acrescenta o modo de função e a ligação ao hardware: com
+ * DISPLAY_SSD1306 em 1 (padrão no Arduino) inclui services/displaySSD1306.h, usa o SSD1306 por
+ * I2C como backend padrão e rasteriza o texto com o Adafruit_GFX. Com DISPLAY_SSD1306 em 0 não
+ * há dependência do Wire nem da Adafruit: o backend é escolhido com setBackend() (ex.: o
+ * FbMemory_c, para rodar e medir a lógica do display no host) e o texto usa a fonte embutida.
  */
 
-#include <Wire.h>
-#include <Adafruit_SSD1306.h>
+#include "../util/fbScreen.h"
 
-#define SCREEN_ADDRESS 0x3C ///< Endereço I2C do display OLED.
-#define SCREEN_WIDTH 128    ///< Largura do display em pixels.
-#define SCREEN_HEIGHT 64    ///< Altura do display em pixels.
-#define OLED_RESET -1       ///< Pino de reset (ou -1 para compartilhar com o reset do Arduino).
+#ifndef DISPLAY_SSD1306
+#ifdef ARDUINO
+#define DISPLAY_SSD1306 1 ///< Liga o Display_c ao SSD1306 por I2C (displaySSD1306.h).
+#else
+#define DISPLAY_SSD1306 0
+#endif
+#endif
 
-Adafruit_SSD1306 SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#if DISPLAY_SSD1306
+#include "displaySSD1306.h"
+#endif
 
 /**
  * @class Display_c
  * @brief Classe para gerenciamento de displays OLED.
  */
-class Display_c {
+class Display_c : public FbScreen_c {
 protected:
-    /**
-     * @brief Realiza a rolagem de texto na linha especificada.
-     * @param index Índice da linha a ser rolada.
-     */
-    void rotaty(uint8_t index);
-
     /**
      * @brief Inicializa o display OLED.
      * @param SDA Pino SDA para comunicação I2C.
@@ -39,21 +45,15 @@ protected:
      */
     bool start(const uint8_t &SDA = 0, const uint8_t &SCL = 0);
 
-    /**
-     * @brief Atualiza o conteúdo do display OLED.
-     */
-    void update(void);
-
     bool isFuncMode = false; ///< Indica se o display está no modo de função.
-    bool isChanged = true; ///< Indica se houve alteração no conteúdo do display.
-    bool scrollLeft[3] = {false, false, false}; ///< Flags de rolagem para cada linha.
-    char ca_lineTxt[3][20] = {"Inicializando...", "", ""}; ///< Conteúdo das linhas do display.
-    uint8_t ui8_lineSize[3] = {16, 0, 0}; ///< Tamanho do texto de cada linha.
-    uint8_t ui8_txtSize[3] = {2, 2, 2}; ///< Tamanho da fonte para cada linha.
-    int16_t i16_lineWidth[3] = {12, 12, 12}; ///< Largura inicial do texto em cada linha.
-    int16_t i16_lineMinWidth[3]; ///< Largura mínima para rolagem do texto.
 
 public:
+#if DISPLAY_SSD1306
+    Display_c() : FbScreen_c(&ssd1306Backend, ssd1306Rasterize) {}
+#else
+    Display_c() = default;
+#endif
+
     /**
      * @brief Configura o texto a ser exibido em uma linha do display.
      * @param line Índice da linha (1 a 3).
@@ -90,72 +90,31 @@ inline bool startDisplay(Display_c *disp, const uint8_t &SDA, const uint8_t &SCL
 }
 
 bool Display_c::start(const uint8_t &SDA, const uint8_t &SCL) {
+#if DISPLAY_SSD1306
     if (SDA != 0 && SCL != 0) {
         Wire.setPins(SDA, SCL);
     }
-    if (!SSD1306.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-        return false;
-    }
-    setText(1, ca_lineTxt[0]);
-    setText(2, ca_lineTxt[1]);
-    setText(3, ca_lineTxt[2]);
-    return true;
+#else
+    (void)SDA;
+    (void)SCL;
+#endif
+    return begin();
 }
 
 inline void updateDisplay(Display_c *disp) {
     disp->update();
 }
 
-void Display_c::update(void) {
-    if (ui8_lineSize[0] > 10 || ui8_lineSize[1] > 10 || ui8_lineSize[2] > 10 || isChanged) {
-        isChanged = false;
-        SSD1306.clearDisplay();
-        SSD1306.setTextWrap(false);
-        SSD1306.setTextColor(SSD1306_WHITE);
-        SSD1306.cp437(true);
-        rotaty(0);
-        rotaty(1);
-        rotaty(2);
-        SSD1306.display();
-    }
-}
-
-void Display_c::rotaty(uint8_t index) {
-    if (ui8_lineSize[index] > 10) {
-        SSD1306.setTextSize(ui8_txtSize[index]);
-        SSD1306.setCursor(i16_lineWidth[index], index * 20);
-        SSD1306.print(ca_lineTxt[index]);
-        if (scrollLeft[index]) {
-            ++i16_lineWidth[index];
-        } else {
-            --i16_lineWidth[index];
-        }
-        if (i16_lineWidth[index] < i16_lineMinWidth[index]) {
-            scrollLeft[index] = true;
-        }
-        if (i16_lineWidth[index] > 12) {
-            scrollLeft[index] = false;
-        }
-    } else {
-        SSD1306.setTextSize(ui8_txtSize[index]);
-        SSD1306.setCursor(0, index * 20);
-        SSD1306.println(ca_lineTxt[index]);
-    }
-}
-
 void Display_c::setText(uint8_t line, const char txt[], bool funcMode, uint8_t txtSize) {
     if (this->isFuncMode == funcMode) {
-        strcpy(ca_lineTxt[line - 1], txt);
-        ui8_lineSize[line - 1] = strlen(ca_lineTxt[line - 1]);
-        i16_lineMinWidth[line - 1] = -12 * (ui8_lineSize[line - 1] - 9);
-        ui8_txtSize[line - 1] = txtSize;
-        isChanged = true;
+        FbScreen_c::setText(line, txt, txtSize);
+    } else {
+        update();
     }
-    update();
 }
 
 void Display_c::setFuncMode(bool funcMode) {
     this->isFuncMode = funcMode;
 }
 
-#endif 
\ No newline at end of file
+#endif
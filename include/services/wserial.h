@@ -9,6 +9,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <atomic>
+#include <mutex>
+#include <esp_timer.h>
+
+#include "../util/clockSync.h"
 
 #define BAUD_RATE 115200
 #define NEWLINE "\r\n"
@@ -17,9 +22,25 @@
 #define WSR_MAX_POINTS_PER_PACKET 1024
 #endif
 
-// // tamanho máximo calculado do pacote
+// MTU do caminho UDP: 1500 (WiFi/Ethernet) - 20 (IPv4) - 8 (UDP).
+// Nenhum datagrama gerado por plot/plotRaw ultrapassa esse valor (sem fragmentação IP).
+#ifndef WSR_PATH_MTU
+#define WSR_PATH_MTU 1472
+#endif
+
+// // tamanho máximo calculado do pacote (limitado ao MTU do caminho)
 #ifndef WSR_MAX_PACKET_SIZE
-#define WSR_MAX_PACKET_SIZE 4096 
+#define WSR_MAX_PACKET_SIZE WSR_PATH_MTU
+#endif
+
+// Número de buffers de pacote no pool estático (máx. 32).
+#ifndef WSR_PACKET_POOL_LEN
+#define WSR_PACKET_POOL_LEN 4
+#endif
+
+// Intervalo entre trocas SYNC/SYNCR com o assinante (0 desativa a sincronização).
+#ifndef WSR_SYNC_INTERVAL_MS
+#define WSR_SYNC_INTERVAL_MS 2000
 #endif
 
 // #ifndef WSR_MAX_POINTS_PER_PACKET
@@ -42,203 +63,56 @@ namespace wserial {
     AsyncUDP udp;
     std::function<void(std::string)> on_input;
 
-    inline void sendLineRaw(const char *txt, size_t len) {
-      if (isUdpLinked) {
-          udp.writeTo(reinterpret_cast<const uint8_t*>(txt),
-                      len, lasecPlotIP, lasecPlotReceivePort);
-      } else {
-        Serial.write(reinterpret_cast<const uint8_t*>(txt),len);
-      }
-    }
-    
-    inline void sendLine(const String &s) {
-        sendLineRaw(s.c_str(), s.length());
-    }
-
-    inline void sendLine(const char *txt) {
-        sendLineRaw(txt, strlen(txt));
-    }
-
-    template <typename T>
-    inline void sendLine(const T &txt) {
-      String s(txt);
-      sendLine(s);
-    }
-
-    bool parseHostPort(const String &s,String &cmd, String &host, uint16_t &port) {
-      int c1 = s.indexOf(':');      // primeiro ':'
-      int c2 = s.lastIndexOf(':');  // último ':'
-
-      if (c1 <= 0 || c2 <= c1) return false;
-
-      cmd  = s.substring(0, c1);
-      host = s.substring(c1 + 1, c2);
-
-      long v = s.substring(c2 + 1).toInt();
-      if (v <= 0 || v > 65535) return false;
-      port = (uint16_t)v;
-      return true;
-    }
-
-    void handleOnPacket(AsyncUDPPacket packet) {
-      String s((const char*)packet.data(), packet.length());
-      s.trim();
-      
-      String cmd, host;
-      uint16_t port;
-
-      if(!parseHostPort(s,cmd,host,port)) { 
-        on_input(std::string(s.c_str()));
-        return;
-      }
-
-      // Seta o lasecPlotIP 
-      IPAddress ip;
-      if (!ip.fromString(host)) {
-        if (WiFi.hostByName(host.c_str(), ip) != 1) {
-          Serial.printf("[UDP] DNS fail: %s\n", host.c_str());
-          return;
-        }
-      } 
-      if (ip == IPAddress()) { Serial.println("[UDP] Invalid IP"); return; }
-
-      lasecPlotIP = ip;
-      lasecPlotReceivePort = port;   // Seta o lasecPlotReceivePort 
-
-      if (cmd == "CONNECT") { // s = "CONNECT:<LASECPLOT_IP>:<LASECPLOT_RECIVE_PORT>"
-        isUdpLinked = true;
-        const String txt = "CONNECT:" + WiFi.localIP().toString() + ":" + String(lasecPlotReceivePort) + "\n";
-        sendLine(txt);
-        Serial.printf("[UDP] Linked to %s:%u (OK sent)\n", lasecPlotIP.toString().c_str(), lasecPlotReceivePort);
-        return;
-      } else {
-        if (cmd == "DISCONNECT"){ // Envia DISCONNECT:<LASECPLOT_IP>:<LASECPLOT_RECIVE_PORT> para o alvo atual (se houver)
-          if (isUdpLinked) {
-            const String txt = "DISCONNECT:" + WiFi.localIP().toString() + ":" + String(lasecPlotReceivePort) + "\n";
-            sendLine(txt);
-            Serial.printf("[UDP] Linked to %s:%u (BYE sent)\n", lasecPlotIP.toString().c_str(), lasecPlotReceivePort);
-            isUdpLinked = false;
-            return;
+    // Tamanho de cada buffer do pool: o menor entre WSR_MAX_PACKET_SIZE e WSR_PATH_MTU.
+    constexpr size_t PACKET_SIZE = (WSR_MAX_PACKET_SIZE < WSR_PATH_MTU) ? WSR_MAX_PACKET_SIZE : WSR_PATH_MTU;
+    static_assert(WSR_PACKET_POOL_LEN >= 1 && WSR_PACKET_POOL_LEN <= 32, "WSR_PACKET_POOL_LEN deve estar entre 1 e 32");
+    static_assert(PACKET_SIZE >= 64, "WSR_PATH_MTU muito pequeno");
+
+    size_t pathMtu = PACKET_SIZE; ///< MTU efetivo em tempo de execução (<= PACKET_SIZE).
+
+    /**
+     * @brief Pool estático de buffers de pacote.
+     *
+     * Substitui os buffers de 4 KB que plot/plotRaw alocavam na pilha da task chamadora.
+     * A ocupação é um bitmask atômico, então tasks diferentes podem montar pacotes ao mesmo
+     * tempo sem mutex. Se todos os buffers estiverem em uso o pacote é descartado e contado.
+     */
+    class PacketPool {
+    public:
+      uint8_t *acquire() {
+        uint32_t used = _used.load(std::memory_order_relaxed);
+        for (;;) {
+          uint32_t freeMask = ~used & ALL;
+          if (freeMask == 0) {
+            _drops.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
           }
+          uint32_t bit = freeMask & (0u - freeMask); // bit livre menos significativo
+          if (_used.compare_exchange_weak(used, used | bit, std::memory_order_acquire, std::memory_order_relaxed))
+            return _bufs[__builtin_ctz(bit)];
         }
       }
-    }
-  }
-  
-  void setup(unsigned long baudrate = BAUD_RATE, uint16_t port=47268) {
-    using namespace detail;
-    Serial.begin(baudrate);
-    while (!Serial)
-      delay(1);
-
-    listenPort = port;
-    // Tenta listen até conseguir
-    if (udp.listen(listenPort)) {
-      isUdpAvailable = true;
-      udp.onPacket(handleOnPacket);
-      Serial.println("[UDP] Listening on " + String(listenPort));
-    } else {
-      isUdpAvailable = false;
-      Serial.println("[UDP] listen() failed");
-    }
-  }
-
-  void loop() {
-    using namespace detail;
-    // Se o listen falhou no setup, tente novamente de tempos em tempos
-    static uint32_t lastRetry = 0;
-    if (!isUdpAvailable && (millis() - lastRetry > 2000)) {
-      lastRetry = millis();
-      if (udp.listen(listenPort)) {
-        isUdpAvailable = true;
-        udp.onPacket(handleOnPacket);
-        Serial.println("[UDP] Listening on " + String(listenPort) + " (retry ok)");
-      }
-    }
-    if(Serial.available()){
-      String linha = Serial.readStringUntil('\n'); // Lê até '\n'
-      on_input(linha.c_str());
-    }
-  }
-  void onInputReceived(std::function<void(std::string)> callback) { detail::on_input = callback; }
-
-  // === API pública ===
-  template<typename T>
-  void plot(const char *varName, uint32_t dt_ms, const T* y, size_t ylen, const char *unit=nullptr)
-  {
-      if (!varName || !y || ylen == 0) return;
-      static uint32_t base = 0;
-      size_t offset = 0;
-      char buf[WSR_MAX_PACKET_SIZE];  // <<< buffer FIXO, sem malloc
 
-      while (offset < ylen) {
-          size_t chunk = ylen - offset;
-          if (chunk > WSR_MAX_POINTS_PER_PACKET) chunk = WSR_MAX_POINTS_PER_PACKET;
-          size_t pos = 0;
-          uint32_t ts0 = base + dt_ms * offset;
-          // Cabeçalho: >nome:TS0;STEP;
-          pos += snprintf(buf + pos, sizeof(buf) - pos,">%s:%u;%u;",varName, ts0, dt_ms);
-          // Valores
-          for (size_t i = 0; i < chunk; i++) {
-              pos += snprintf(buf + pos, sizeof(buf) - pos,"%.2f", (double)y[offset + i]);
-              if (i < chunk - 1) buf[pos++] = ';';
-          }
-          // Unidade opcional
-          if (unit) pos += snprintf(buf + pos, sizeof(buf) - pos, "§%s", unit);
-          // Fim
-          pos += snprintf(buf + pos, sizeof(buf) - pos, "|g\r\n");
-          // Envia
-          detail::sendLineRaw(buf, pos);
-          // Avança para próximo pedaço
-          offset += chunk;
+      void release(uint8_t *buf) {
+        size_t idx = (size_t)(buf - _bufs[0]) / PACKET_SIZE;
+        _used.fetch_and(~(1u << idx), std::memory_order_release);
       }
-      // Atualiza base (primeiro timestamp do próximo lote)
-      base += dt_ms * ylen;
-  }
-
-#pragma once
-// wserial.h — UDP (AsyncUDP) header-only, com CONNECT/DISCONNECT
-// Use: wserial::beginUDP(47268);  wserial::loopUDP();  wserial::sendLineTo("msg\n");
-#include <Arduino.h>
-#include <WiFi.h>
-#include <AsyncUDP.h>
-#include <stdint.h>
-#include <stddef.h>
-#include <stdio.h>
-#include <string.h>
-#include <math.h>
-
-#define BAUD_RATE 115200
-#define NEWLINE "\r\n"
-
-#ifndef WSR_MAX_POINTS_PER_PACKET
-#define WSR_MAX_POINTS_PER_PACKET 1024
-#endif
 
-// // tamanho máximo calculado do pacote
-#ifndef WSR_MAX_PACKET_SIZE
-#define WSR_MAX_PACKET_SIZE 4096 
-#endif
+      uint32_t drops() const { return _drops.load(std::memory_order_relaxed); }
 
-// #ifndef WSR_MAX_POINTS_PER_PACKET
-// #define WSR_MAX_POINTS_PER_PACKET 128
-// #endif
+    private:
+      static constexpr uint32_t ALL = (WSR_PACKET_POOL_LEN == 32) ? 0xFFFFFFFFu : ((1u << WSR_PACKET_POOL_LEN) - 1u);
+      alignas(4) uint8_t _bufs[WSR_PACKET_POOL_LEN][PACKET_SIZE];
+      std::atomic<uint32_t> _used{0};
+      std::atomic<uint32_t> _drops{0};
+    };
 
-// // tamanho máximo calculado do pacote
-// #ifndef WSR_MAX_PACKET_SIZE
-// #define WSR_MAX_PACKET_SIZE (64 + (WSR_MAX_POINTS_PER_PACKET * 32))
-// #endif
+    PacketPool packetPool;
 
-namespace wserial {
-  namespace detail {
-    IPAddress lasecPlotIP;
-    uint16_t  lasecPlotReceivePort = 0;
-    uint16_t listenPort = 0;
-    bool isUdpAvailable = false;
-    bool isUdpLinked = false;
-
-    AsyncUDP udp;
-    std::function<void(std::string)> on_input;
+    ClockSync_c clockSync;        ///< Offset/deriva em relação ao relógio do assinante.
+    std::mutex clockMutex;        ///< clockSync é atualizado pela task do AsyncUDP.
+    bool useHostTimestamps = false; ///< Se true, os quadros levam timestamps do host em µs.
+    std::atomic<uint8_t> syncBurst{0}; ///< Trocas rápidas pendentes após o CONNECT (escrito pela task do AsyncUDP).
 
     inline void sendLineRaw(const char *txt, size_t len) {
       if (isUdpLinked) {
@@ -263,6 +137,31 @@ namespace wserial {
       sendLine(s);
     }
 
+    /**
+     * @brief Timestamp (µs do host) da primeira amostra de um lote, ou -1 se desativado.
+     */
+    inline int64_t hostBatchStart(uint32_t dt_ms, size_t ylen) {
+      if (!useHostTimestamps) return -1;
+      std::lock_guard<std::mutex> lock(clockMutex);
+      return clockSync.toHost(esp_timer_get_time()) - (int64_t)dt_ms * 1000 * (int64_t)(ylen - 1);
+    }
+
+    /**
+     * @brief Escreve o cabeçalho ">nome:TS0;STEP;" de um pacote de lote.
+     * @return Número de caracteres escritos (limitado a len - 1).
+     */
+    inline size_t header(char *buf, size_t len, const char *varName, uint32_t ts0,
+                         int64_t hostT0, uint32_t dt_ms, size_t offset) {
+      int n;
+      if (hostT0 >= 0)
+        n = snprintf(buf, len, ">%s:@%lld;%u;", varName,
+                     (long long)(hostT0 + (int64_t)dt_ms * 1000 * (int64_t)offset), dt_ms);
+      else
+        n = snprintf(buf, len, ">%s:%u;%u;", varName, ts0, dt_ms);
+      if (n < 0) return 0;
+      return ((size_t)n < len) ? (size_t)n : len - 1;
+    }
+
     bool parseHostPort(const String &s,String &cmd, String &host, uint16_t &port) {
       int c1 = s.indexOf(':');      // primeiro ':'
       int c2 = s.lastIndexOf(':');  // último ':'
@@ -279,8 +178,15 @@ namespace wserial {
     }
 
     void handleOnPacket(AsyncUDPPacket packet) {
+      const int64_t t4 = esp_timer_get_time(); // instante de chegada, antes de qualquer parsing
       String s((const char*)packet.data(), packet.length());
       s.trim();
+
+      if (s.startsWith("SYNCR:")) { // s = "SYNCR:<seq>:<t1>:<t2>:<t3>"
+        std::lock_guard<std::mutex> lock(clockMutex);
+        clockSync.handleResponse(s.c_str(), t4);
+        return;
+      }
       
       String cmd, host;
       uint16_t port;
@@ -305,6 +211,11 @@ namespace wserial {
 
       if (cmd == "CONNECT") { // s = "CONNECT:<LASECPLOT_IP>:<LASECPLOT_RECIVE_PORT>"
         isUdpLinked = true;
+        {
+          std::lock_guard<std::mutex> lock(clockMutex);
+          clockSync.reset();  // novo assinante, novo relógio
+        }
+        syncBurst.store(4, std::memory_order_relaxed);
         const String txt = "CONNECT:" + WiFi.localIP().toString() + ":" + String(lasecPlotReceivePort) + "\n";
         sendLine(txt);
         Serial.printf("[UDP] Linked to %s:%u (OK sent)\n", lasecPlotIP.toString().c_str(), lasecPlotReceivePort);
@@ -353,6 +264,22 @@ namespace wserial {
         Serial.println("[UDP] Listening on " + String(listenPort) + " (retry ok)");
       }
     }
+    // Sincronização de relógio com o assinante: rajada curta após o CONNECT, depois periódica.
+    static uint32_t lastSync = 0;
+    uint8_t burst = syncBurst.load(std::memory_order_relaxed);
+    if (WSR_SYNC_INTERVAL_MS > 0 && isUdpLinked &&
+        (millis() - lastSync >= (burst ? 100u : (uint32_t)WSR_SYNC_INTERVAL_MS))) {
+      lastSync = millis();
+      // Se um CONNECT recomeçou a rajada desde a leitura, o novo valor prevalece.
+      if (burst) syncBurst.compare_exchange_strong(burst, burst - 1, std::memory_order_relaxed);
+      char req[48];
+      size_t n;
+      {
+        std::lock_guard<std::mutex> lock(clockMutex);
+        n = clockSync.makeRequest(req, sizeof(req), esp_timer_get_time());
+      }
+      if (n) sendLineRaw(req, n);
+    }
     if(Serial.available()){
       String linha = Serial.readStringUntil('\n'); // Lê até '\n'
       on_input(linha.c_str());
@@ -360,6 +287,50 @@ namespace wserial {
   }
   void onInputReceived(std::function<void(std::string)> callback) { detail::on_input = callback; }
 
+  /**
+   * @brief Ajusta o MTU do caminho usado para empacotar plot/plotRaw.
+   *
+   * Útil quando há túneis (VPN, PPPoE) que reduzem o MTU abaixo de WSR_PATH_MTU.
+   * O valor é limitado ao tamanho dos buffers do pool.
+   * @param mtu Tamanho máximo do payload UDP em bytes.
+   */
+  void setPathMtu(size_t mtu) {
+    if (mtu < 64) mtu = 64;
+    detail::pathMtu = (mtu < detail::PACKET_SIZE) ? mtu : detail::PACKET_SIZE;
+  }
+
+  /**
+   * @brief Instante atual no relógio do assinante, em µs.
+   *
+   * Enquanto não houver sincronização retorna o relógio local (esp_timer_get_time()).
+   */
+  int64_t hostMicros() {
+    std::lock_guard<std::mutex> lock(detail::clockMutex);
+    return detail::clockSync.toHost(esp_timer_get_time());
+  }
+  
+  /**
+   * @brief Indica se já houve ao menos uma troca SYNC/SYNCR válida.
+   */
+  bool isClockSynced() {
+    std::lock_guard<std::mutex> lock(detail::clockMutex);
+    return detail::clockSync.isSynced();
+  }
+
+  /**
+   * @brief Ativa timestamps sincronizados com o host nos quadros de plot/plotRaw.
+   *
+   * Com a opção ativa o timestamp do cabeçalho passa a ser "@<µs do host>" em vez de ms locais.
+   * Para lotes, considera-se que a última amostra foi capturada no instante da chamada.
+   * @param enable true para ativar.
+   */
+  void setHostTimestamps(bool enable) { detail::useHostTimestamps = enable; }
+
+  /**
+   * @brief Número de pacotes descartados por falta de buffer livre no pool.
+   */
+  uint32_t droppedPackets() { return detail::packetPool.drops(); }
+
   // === API pública ===
   void plotRaw(const char* varName,
                   uint32_t dt_ms,
@@ -373,10 +344,16 @@ namespace wserial {
 
       static uint32_t base = 0;
       size_t offset = 0;
-      alignas(4) unsigned char buf[WSR_MAX_PACKET_SIZE];
+      const int64_t hostT0 = detail::hostBatchStart(dt_ms, ylen);
+      uint8_t *buf = detail::packetPool.acquire();  // buffer do pool, fora da pilha
+      if (!buf) {  // lote descartado (contado em droppedPackets()); o tempo continua andando
+          base += dt_ms * (uint32_t)ylen;
+          return;
+      }
+      const size_t mtu = detail::pathMtu;
 
       const size_t unit_len = unit ? strlen(unit) : 0;
-      const size_t tail_len = (unit ? (2 + unit_len) : 0) + 3; // "§"+unit+"|g\r\n"
+      const size_t tail_len = (unit ? (2 + unit_len) : 0) + 4; // "§"+unit+"|g\r\n"
 
       while (offset < ylen) {
 
@@ -384,11 +361,10 @@ namespace wserial {
           size_t pos = 0;
 
           // Cabeçalho ASCII
-          pos += snprintf((char*)buf + pos,
-                          sizeof(buf) - pos,
-                          ">%s:%u;%u;", varName, ts0, dt_ms);
+          pos += detail::header((char*)buf, mtu, varName, ts0, hostT0, dt_ms, offset);
 
-          if (pos + 8 + tail_len >= sizeof(buf)) {  // nem cabe min/max
+          if (pos + 8 + 2 + tail_len > mtu) {  // nem cabe min/max + 1 ponto
+              pos = (pos < mtu - 4) ? pos : mtu - 4;
               buf[pos++] = '|'; buf[pos++] = 'g';
               buf[pos++] = '\r'; buf[pos++] = '\n';
               detail::sendLineRaw((char*)buf, pos);
@@ -399,13 +375,12 @@ namespace wserial {
           memcpy(buf + pos, &mn, 4); pos += 4;
           memcpy(buf + pos, &mx, 4); pos += 4;
 
-          // Quanto cabe no pacote?
-          size_t room = sizeof(buf) - pos - tail_len;
-          size_t chunk = room / 2;                 // cada ponto = uint16_t
+          // Quanto cabe no pacote? Fronteira sempre em amostras inteiras.
+          size_t room = mtu - pos - tail_len;
+          size_t chunk = room / sizeof(uint16_t);
 
           if (chunk > WSR_MAX_POINTS_PER_PACKET) chunk = WSR_MAX_POINTS_PER_PACKET;
           if (chunk > (ylen - offset))             chunk = ylen - offset;
-          if (chunk == 0) break;
 
           // Copia valores uint16_t DIRETO (sem quantização)
           memcpy(buf + pos, y + offset, chunk * sizeof(uint16_t));
@@ -429,6 +404,7 @@ namespace wserial {
           offset += chunk;
       }
 
+      detail::packetPool.release(buf);
       base += dt_ms * (uint32_t)ylen;
   }
 
@@ -438,29 +414,41 @@ namespace wserial {
       if (!varName || !y || ylen == 0) return;
       static uint32_t base = 0;
       size_t offset = 0;
-      char buf[WSR_MAX_PACKET_SIZE];  // <<< buffer FIXO, sem malloc
+      const int64_t hostT0 = detail::hostBatchStart(dt_ms, ylen);
+      char *buf = (char*)detail::packetPool.acquire();  // <<< buffer do pool, sem malloc e fora da pilha
+      if (!buf) {  // lote descartado (contado em droppedPackets()); o tempo continua andando
+          base += dt_ms * ylen;
+          return;
+      }
+      const size_t mtu = detail::pathMtu;
+      const size_t tail_len = (unit ? (2 + strlen(unit)) : 0) + 4; // "§"+unit+"|g\r\n"
 
       while (offset < ylen) {
-          size_t chunk = ylen - offset;
-          if (chunk > WSR_MAX_POINTS_PER_PACKET) chunk = WSR_MAX_POINTS_PER_PACKET;
+          size_t chunk = 0;
           size_t pos = 0;
           uint32_t ts0 = base + dt_ms * offset;
-          // Cabeçalho: >nome:TS0;STEP;
-          pos += snprintf(buf + pos, sizeof(buf) - pos,">%s:%u;%u;",varName, ts0, dt_ms);
-          // Valores
-          for (size_t i = 0; i < chunk; i++) {
-              pos += snprintf(buf + pos, sizeof(buf) - pos,"%.2f", (double)y[offset + i]);
-              if (i < chunk - 1) buf[pos++] = ';';
+          // Cabeçalho: >nome:TS0;STEP;  (ou >nome:@TS0_US;STEP; com timestamps do host)
+          pos += detail::header(buf, mtu, varName, ts0, hostT0, dt_ms, offset);
+          // Valores: só entra a amostra que couber inteira junto com o final
+          while (offset + chunk < ylen && chunk < WSR_MAX_POINTS_PER_PACKET) {
+              char num[32];
+              int len = snprintf(num, sizeof(num), "%s%.2f", chunk ? ";" : "", (double)y[offset + chunk]);
+              if (len < 0 || pos + (size_t)len + tail_len > mtu) break;
+              memcpy(buf + pos, num, len);
+              pos += len;
+              chunk++;
           }
+          if (chunk == 0) break; // nome grande demais para o MTU
           // Unidade opcional
-          if (unit) pos += snprintf(buf + pos, sizeof(buf) - pos, "§%s", unit);
+          if (unit) pos += snprintf(buf + pos, mtu - pos, "§%s", unit);
           // Fim
-          pos += snprintf(buf + pos, sizeof(buf) - pos, "|g\r\n");
+          pos += snprintf(buf + pos, mtu - pos, "|g\r\n");
           // Envia
           detail::sendLineRaw(buf, pos);
           // Avança para próximo pedaço
           offset += chunk;
       }
+      detail::packetPool.release((uint8_t*)buf);
       // Atualiza base (primeiro timestamp do próximo lote)
       base += dt_ms * ylen;
   }
@@ -477,7 +465,10 @@ namespace wserial {
     pos += snprintf(buf + pos, sizeof(buf) - pos, ">%s:", varName);
 
     // timestamp
-    pos += snprintf(buf + pos, sizeof(buf) - pos, "%u:", (uint32_t)x);
+    if (detail::useHostTimestamps)
+      pos += snprintf(buf + pos, sizeof(buf) - pos, "@%lld:", (long long)hostMicros());
+    else
+      pos += snprintf(buf + pos, sizeof(buf) - pos, "%u:", (uint32_t)x);
 
     // valor (converte qualquer T)
     pos += snprintf(buf + pos, sizeof(buf) - pos, "%.2f", (double)y);
@@ -520,59 +511,3 @@ namespace wserial {
     detail::sendLine(NEWLINE);
   }
 }
-
-  template <typename T>
-  void plot(const char *varName, TickType_t x, T y, const char *unit = nullptr) 
-  {
-    // Máximo possível e seguro:
-    // varName (30) + números (20) + unit (10) + overhead
-    char buf[96];  
-    size_t pos = 0;
-
-    // Prefixo
-    pos += snprintf(buf + pos, sizeof(buf) - pos, ">%s:", varName);
-
-    // timestamp
-    pos += snprintf(buf + pos, sizeof(buf) - pos, "%u:", (uint32_t)x);
-
-    // valor (converte qualquer T)
-    pos += snprintf(buf + pos, sizeof(buf) - pos, "%.2f", (double)y);
-
-    // unidade, se existir
-    if (unit)
-        pos += snprintf(buf + pos, sizeof(buf) - pos, "§%s", unit);
-
-    // sufixo
-    pos += snprintf(buf + pos, sizeof(buf) - pos, "|g" NEWLINE);
-    detail::sendLineRaw(buf, pos);
-  }
-
-  template <typename T>
-  void plot(const char *varName, T y, const char *unit= nullptr)  {
-    plot(varName, (TickType_t) xTaskGetTickCount(), y, unit);
-  }
-
-  void log(const char *text, uint32_t ts_ms)  {
-    if (ts_ms == 0)
-      ts_ms = millis();
-    String line = String(ts_ms);
-    line += ":";
-    line += String(text ? text : "");
-    line += NEWLINE;
-    detail::sendLine(line);
-  }
-  
-  template <typename T>
-  inline void println(const T &data)  {
-    detail::sendLine(String(data) + NEWLINE);
-  }
-
-  template <typename T>
-  inline void print(const T &data)  {
-    detail::sendLine(data);
-  }
-  
-  inline void println()  {
-    detail::sendLine(NEWLINE);
-  }
-}
\ No newline at end of file
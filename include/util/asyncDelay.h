@@ -11,6 +11,9 @@
  * sem bloquear a execução do código. Uma vez expirado, o intervalo pode se repetir
  * automaticamente, ou pode ser reiniciado manualmente. Ela não depende de RTOS, portanto
  * é compatível com plataformas Arduino clássicas (como o UNO) e ESP32 com Arduino Core.
+ *
+ * Com muitos intervalos consultados a cada loop, WheelTimer_c (timerWheel.h) oferece a
+ * mesma interface sobre uma roda de tempo única, avançada uma vez por passagem.
  */
 class AsyncDelay_c {
 protected:
@@ -0,0 +1,141 @@
+#ifndef __ASYNCDELAYUS_H
+#define __ASYNCDELAYUS_H
+
+/**
+ * @file asyncDelayUs.h
+ * @brief Variante de AsyncDelay_c em microssegundos, com relógio monotônico de 64 bits.
+ *
+ * Usa esp_timer_get_time() no ESP32 (steady_clock no host), então não dá a volta e permite
+ * intervalos abaixo de 1 ms. Os vencimentos são sempre múltiplos exatos do intervalo a
+ * partir do restart() (sem deriva), e isExpired() informa quantos períodos passaram, de
+ * modo que um atraso no loop é visível para quem chama. Dois comportamentos após um atraso:
+ *
+ * - ASYNCDELAY_SKIP: isExpired() devolve todos os períodos vencidos de uma vez e agenda o
+ *   próximo vencimento futuro (os períodos extras são somados em missed()).
+ * - ASYNCDELAY_CATCHUP: cada chamada consome um período e devolve quantos estão vencidos,
+ *   incluindo o atual; o chamador roda uma vez por chamada até zerar o atraso.
+ *
+ * Uso:
+ *   AsyncDelayUs_c amostra(250);          // 4 kHz
+ *   loop() {
+ *     if (uint32_t n = amostra.isExpired()) { if (n > 1) perdeu(n - 1); ler(); }
+ *   }
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_timer.h>
+#else
+#include <stdint.h>
+#include <chrono>
+#endif
+
+/**
+ * @brief O que fazer quando mais de um período venceu entre duas consultas.
+ */
+enum asyncDelayPolicy_t : uint8_t {
+  ASYNCDELAY_SKIP,   ///< Informa todos de uma vez e pula para o próximo vencimento futuro.
+  ASYNCDELAY_CATCHUP ///< Entrega um período por chamada até recuperar o atraso.
+};
+
+/**
+ * @class AsyncDelayUs_c
+ * @brief Intervalo assíncrono em microssegundos, sem deriva.
+ */
+class AsyncDelayUs_c {
+protected:
+  int64_t _expires = 0;  ///< Instante (µs) do próximo vencimento.
+  int64_t _interval = 0; ///< Duração do intervalo em microssegundos.
+  uint32_t _missed = 0;  ///< Períodos pulados (política ASYNCDELAY_SKIP).
+  asyncDelayPolicy_t _policy;
+  int64_t (*_clock)() = nowUs;
+
+public:
+  /**
+   * @brief Construtor que inicializa o intervalo e define o instante de vencimento.
+   * @param intervalUs Duração do intervalo em microssegundos.
+   * @param policy Comportamento quando vários períodos vencem entre duas consultas.
+   */
+  AsyncDelayUs_c(int64_t intervalUs, asyncDelayPolicy_t policy = ASYNCDELAY_SKIP) : _policy(policy) {
+    restart(intervalUs);
+  }
+
+  /**
+   * @brief Reinicia o intervalo a partir de agora.
+   * @param intervalUs Nova duração do intervalo em microssegundos.
+   */
+  void restart(int64_t intervalUs) {
+    _interval = intervalUs > 0 ? intervalUs : 0;
+    _expires = _clock() + _interval;
+    _missed = 0;
+  }
+
+  /**
+   * @brief Verifica quantos períodos venceram.
+   * @return 0 se ainda não venceu; caso contrário o número de períodos vencidos
+   *         (1 se a consulta veio a tempo). Ver asyncDelayPolicy_t.
+   */
+  uint32_t isExpired() {
+    int64_t late = _clock() - _expires;
+    if (late < 0) return 0;
+    if (_interval == 0) return 1;
+    int64_t periods = late / _interval + 1;
+    uint32_t n = periods > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)periods;
+    if (_policy == ASYNCDELAY_CATCHUP) {
+      _expires += _interval;
+    } else {
+      _expires += periods * _interval;
+      _missed += n - 1;
+    }
+    return n;
+  }
+
+  /**
+   * @brief Agenda o próximo vencimento um intervalo depois do último.
+   */
+  void repeat() { _expires += _interval; }
+
+  /**
+   * @brief Altera a política usada por isExpired().
+   */
+  void setPolicy(asyncDelayPolicy_t policy) { _policy = policy; }
+
+  /**
+   * @brief Microssegundos até o próximo vencimento (0 se já venceu).
+   */
+  int64_t remaining() const {
+    int64_t left = _expires - _clock();
+    return left > 0 ? left : 0;
+  }
+
+  /**
+   * @brief Instante (µs) do próximo vencimento.
+   */
+  int64_t expiresAt() const { return _expires; }
+
+  /**
+   * @brief Total de períodos pulados desde o último restart() (política ASYNCDELAY_SKIP).
+   */
+  uint32_t missed() const { return _missed; }
+
+  /**
+   * @brief Substitui o relógio (para testes no host); nullptr volta ao padrão.
+   *
+   * Não altera o vencimento atual; chame restart() em seguida se os relógios diferirem.
+   */
+  void setClock(int64_t (*clock)()) { _clock = clock ? clock : nowUs; }
+
+  /**
+   * @brief Relógio monotônico em microssegundos.
+   */
+  static int64_t nowUs() {
+#ifdef ARDUINO
+    return esp_timer_get_time();
+#else
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+};
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef __CLOCKSYNC_H
+#define __CLOCKSYNC_H
+
+/**
+ * @file clockSync.h
+ * @brief Estimador de offset e deriva de relógio no estilo NTP.
+ *
+ * O kit envia "SYNC:<seq>:<t1>" ao assinante e este responde
+ * "SYNCR:<seq>:<t1>:<t2>:<t3>", onde t2 e t3 são os instantes (em µs, no relógio do host)
+ * de recepção da requisição e de envio da resposta. Ao receber a resposta no instante t4
+ * (relógio local), calcula-se:
+ *
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2     (host - local)
+ *   atraso = (t4 - t1) - (t3 - t2)           (ida e volta na rede)
+ *
+ * Amostras com atraso muito acima do menor atraso recente são descartadas, e a deriva é
+ * estimada por mínimos quadrados sobre as últimas CLOCKSYNC_WINDOW amostras.
+ *
+ * Não depende do Arduino: o mesmo arquivo serve para o kit e para um respondedor no host
+ * (ver ClockSync_c::respond).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CLOCKSYNC_WINDOW
+/**
+ * @brief Número de amostras usadas na regressão de deriva.
+ */
+#define CLOCKSYNC_WINDOW 8
+#endif
+
+#ifndef CLOCKSYNC_DELAY_WINDOW
+/**
+ * @brief Número de trocas recentes (aceitas ou não) usadas para achar o menor atraso.
+ */
+#define CLOCKSYNC_DELAY_WINDOW 16
+#endif
+
+/**
+ * @class ClockSync_c
+ * @brief Mantém a relação entre o relógio local (µs) e o relógio do assinante (µs).
+ */
+class ClockSync_c {
+public:
+    /**
+     * @brief Monta a requisição "SYNC:<seq>:<t1>\n" e guarda t1 para validar a resposta.
+     * @param buf Buffer de saída.
+     * @param len Tamanho do buffer.
+     * @param t1 Instante local de envio (µs).
+     * @return Número de bytes escritos (0 se não couber).
+     */
+    size_t makeRequest(char *buf, size_t len, int64_t t1) {
+        _pendingSeq = ++_seq;
+        _pendingT1 = t1;
+        int n = snprintf(buf, len, "SYNC:%u:%lld\n", (unsigned)_pendingSeq, (long long)t1);
+        return (n < 0 || (size_t)n >= len) ? 0 : (size_t)n;
+    }
+
+    /**
+     * @brief Processa uma resposta "SYNCR:<seq>:<t1>:<t2>:<t3>".
+     * @param msg Texto recebido.
+     * @param t4 Instante local de recepção (µs), medido o mais cedo possível.
+     * @return true se a amostra foi aceita.
+     */
+    bool handleResponse(const char *msg, int64_t t4) {
+        if (strncmp(msg, "SYNCR:", 6) != 0) return false;
+        char *p = (char *)msg + 6;
+        unsigned long seq = strtoul(p, &p, 10);
+        if (*p++ != ':') return false;
+        long long t1 = strtoll(p, &p, 10);
+        if (*p++ != ':') return false;
+        long long t2 = strtoll(p, &p, 10);
+        if (*p++ != ':') return false;
+        long long t3 = strtoll(p, &p, 10);
+
+        // Só aceita a resposta da última requisição (descarta duplicadas e atrasadas).
+        if (seq != _pendingSeq || t1 != _pendingT1) return false;
+        _pendingSeq = 0;
+        return addSample(t1, t2, t3, t4);
+    }
+
+    /**
+     * @brief Adiciona uma troca completa (t1..t4) ao estimador.
+     * @return true se a amostra foi aceita (atraso plausível).
+     */
+    bool addSample(int64_t t1, int64_t t2, int64_t t3, int64_t t4) {
+        int64_t delay = (t4 - t1) - (t3 - t2);
+        if (delay < 0) return false;
+        int64_t offset = ((t2 - t1) + (t3 - t4)) / 2;
+
+        // Filtro de atraso (como o clock filter do NTP): só aceita trocas próximas do menor
+        // atraso recente, pois a assimetria ida/volta (erro do offset) é limitada a atraso / 2.
+        _delays[_delayHead] = delay;
+        _delayHead = (_delayHead + 1) % CLOCKSYNC_DELAY_WINDOW;
+        if (_delayCount < CLOCKSYNC_DELAY_WINDOW) _delayCount++;
+        int64_t minDelay = delay;
+        for (uint8_t i = 0; i < _delayCount; i++)
+            if (_delays[i] < minDelay) minDelay = _delays[i];
+        if (_count > 0 && delay > minDelay + minDelay / 4 + 100) return false;
+
+        if (_count == 0) {
+            _baseLocal = t4;
+            _baseOffset = offset;
+        }
+        Sample_t &s = _samples[_head];
+        s.x = (double)((t1 - _baseLocal) + (t4 - t1) / 2); // meio da troca, no relógio local
+        s.y = (double)(offset - _baseOffset);
+        _head = (_head + 1) % CLOCKSYNC_WINDOW;
+        if (_count < CLOCKSYNC_WINDOW) _count++;
+        _lastDelay = delay;
+        fit();
+        return true;
+    }
+
+    /**
+     * @brief Converte um instante local (µs) para o relógio do assinante (µs).
+     *
+     * Antes da primeira amostra válida retorna o próprio valor local.
+     */
+    int64_t toHost(int64_t localUs) const {
+        if (_count == 0) return localUs;
+        double dx = (double)(localUs - _baseLocal) - _meanX;
+        return localUs + _baseOffset + (int64_t)(_meanY + _slope * dx);
+    }
+
+    /**
+     * @brief Indica se há ao menos uma amostra válida.
+     */
+    bool isSynced() const { return _count > 0; }
+
+    /**
+     * @brief Offset atual estimado (host - local), em µs.
+     */
+    int64_t offset(int64_t localUs) const { return toHost(localUs) - localUs; }
+
+    /**
+     * @brief Deriva estimada do relógio local em relação ao host, em ppm.
+     */
+    double driftPpm() const { return _slope * 1e6; }
+
+    /**
+     * @brief Atraso de ida e volta da última amostra aceita, em µs.
+     */
+    int64_t lastDelay() const { return _lastDelay; }
+
+    /**
+     * @brief Descarta todas as amostras (ex.: ao trocar de assinante).
+     */
+    void reset() {
+        _count = 0;
+        _head = 0;
+        _delayCount = 0;
+        _delayHead = 0;
+        _slope = _meanX = _meanY = 0.0;
+        _pendingSeq = 0;
+    }
+
+    /**
+     * @brief Lado host: monta a resposta a uma requisição "SYNC:<seq>:<t1>".
+     *
+     * @param req Requisição recebida.
+     * @param t2 Instante de recepção no host (µs).
+     * @param t3 Instante de envio no host (µs), lido imediatamente antes de transmitir.
+     * @param out Buffer de saída.
+     * @param len Tamanho do buffer.
+     * @return Número de bytes escritos, ou 0 se a requisição for inválida.
+     */
+    static size_t respond(const char *req, int64_t t2, int64_t t3, char *out, size_t len) {
+        if (strncmp(req, "SYNC:", 5) != 0) return 0;
+        char *p = (char *)req + 5;
+        unsigned long seq = strtoul(p, &p, 10);
+        if (*p++ != ':') return 0;
+        long long t1 = strtoll(p, &p, 10);
+        int n = snprintf(out, len, "SYNCR:%lu:%lld:%lld:%lld\n", seq, t1, (long long)t2, (long long)t3);
+        return (n < 0 || (size_t)n >= len) ? 0 : (size_t)n;
+    }
+
+private:
+    struct Sample_t {
+        double x; ///< Instante local relativo a _baseLocal (µs).
+        double y; ///< Offset relativo a _baseOffset (µs).
+    };
+
+    /**
+     * @brief Ajusta a reta offset(x) por mínimos quadrados.
+     */
+    void fit() {
+        double sx = 0, sy = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            sx += _samples[i].x;
+            sy += _samples[i].y;
+        }
+        _meanX = sx / _count;
+        _meanY = sy / _count;
+        double sxx = 0, sxy = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            double dx = _samples[i].x - _meanX;
+            sxx += dx * dx;
+            sxy += dx * (_samples[i].y - _meanY);
+        }
+        // Janela curta demais (< 1 s) não dá deriva confiável.
+        _slope = (sxx > 1e12) ? sxy / sxx : 0.0;
+    }
+
+    Sample_t _samples[CLOCKSYNC_WINDOW];
+    uint8_t _count = 0;
+    uint8_t _head = 0;
+    int64_t _delays[CLOCKSYNC_DELAY_WINDOW];
+    uint8_t _delayCount = 0;
+    uint8_t _delayHead = 0;
+    uint32_t _seq = 0;
+    uint32_t _pendingSeq = 0;
+    int64_t _pendingT1 = 0;
+    int64_t _baseLocal = 0;
+    int64_t _baseOffset = 0;
+    int64_t _lastDelay = 0;
+    double _meanX = 0.0;
+    double _meanY = 0.0;
+    double _slope = 0.0;
+};
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef __DINBANK_H
+#define __DINBANK_H
+
+/**
+ * @file dinBank.h
+ * @brief Debounce de várias entradas digitais de uma vez, com contadores verticais.
+ *
+ * A cada tick, todas as entradas do ESP32 (GPIO 0 a 39) são lidas de uma só vez pelos
+ * registradores GPIO_IN_REG e GPIO_IN1_REG, e o debounce dos 64 bits é feito em paralelo
+ * com um contador vertical de 2 bits por entrada: um bit só muda de estado depois de
+ * 4 amostras seguidas diferentes do estado atual. O custo é o mesmo para 4 ou 30 entradas,
+ * e as callbacks só são chamadas para os pinos que mudaram.
+ *
+ * O núcleo (dinVCounter_t) é só aritmética de bits, e a função de leitura pode ser trocada
+ * (setReader) para testar no host.
+ *
+ * Uso:
+ *   DinBank_c bank(50);                       // 50 ms de debounce (tick de 12,5 ms)
+ *   bank.watch(34, [](void *, bool v) { ... });
+ *   loop() { bank.update(); }
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <soc/gpio_reg.h>
+#else
+#include <stdint.h>
+#include <chrono>
+#endif
+
+#ifndef DINBANK_MAX
+/**
+ * @brief Número máximo de pinos com callback num DinBank_c.
+ */
+#define DINBANK_MAX 8
+#endif
+
+/**
+ * @struct dinVCounter_t
+ * @brief Contador vertical de 2 bits para 64 entradas.
+ *
+ * Para cada bit, (c1, c0) conta quantas amostras seguidas diferiram de state; ao completar
+ * 4 o bit de state inverte. Qualquer amostra igual a state zera o contador daquele bit.
+ */
+struct dinVCounter_t {
+  uint64_t state; ///< Estado estável (com debounce).
+  uint64_t c0;    ///< Bit menos significativo dos contadores.
+  uint64_t c1;    ///< Bit mais significativo dos contadores.
+
+  /**
+   * @brief Reinicia com um estado conhecido (sem transições pendentes).
+   */
+  void reset(uint64_t initial) {
+    state = initial;
+    c0 = c1 = 0;
+  }
+
+  /**
+   * @brief Processa uma amostra.
+   * @param sample Leitura bruta das entradas.
+   * @return Máscara dos bits cujo estado estável mudou nesta amostra.
+   */
+  uint64_t step(uint64_t sample) {
+    uint64_t delta = sample ^ state; // bits diferentes do estado estável
+    c1 = (c1 ^ c0) & delta;          // conta (ou zera onde delta = 0)
+    c0 = ~c0 & delta;
+    uint64_t toggle = delta & ~(c0 | c1); // contador deu a volta: 4 amostras diferentes
+    state ^= toggle;
+    return toggle;
+  }
+};
+
+/**
+ * @class DinBank_c
+ * @brief Banco de entradas digitais com debounce por contador vertical.
+ */
+class DinBank_c {
+public:
+  /**
+   * @brief Callback chamada quando o estado estável de um pino muda.
+   */
+  typedef void (*CallbackFunc)(void *ctx, bool newState);
+
+  /**
+   * @brief Construtor.
+   * @param debounceMs Tempo de debounce em milissegundos (o tick é 1/4 disso).
+   */
+  DinBank_c(unsigned long debounceMs = 50) : _tickUs(debounceMs * 1000UL / 4) {}
+
+  /**
+   * @brief Passa a observar um pino.
+   * @param pin Número do GPIO (0 a 39).
+   * @param callback Função chamada quando o estado estável do pino mudar (ou nullptr).
+   * @param ctx Contexto repassado à callback.
+   * @param mode Modo do pino (INPUT, INPUT_PULLUP, etc.).
+   * @return false se o pino for inválido ou não houver espaço para a callback.
+   */
+  bool watch(uint8_t pin, CallbackFunc callback = nullptr, void *ctx = nullptr, uint8_t mode = INPUT_PULLDOWN_MODE) {
+    if (pin > 39 || _count >= DINBANK_MAX) return false;
+#ifdef ARDUINO
+    pinMode(pin, mode);
+#else
+    (void)mode;
+#endif
+    uint64_t bit = 1ULL << pin;
+    _entries[_count++] = Entry_t{pin, callback, ctx};
+    _mask |= bit;
+    // Começa no nível atual, sem disparar callback.
+    uint64_t now = _reader() & bit;
+    _vc.state = (_vc.state & ~bit) | now;
+    _vc.c0 &= ~bit;
+    _vc.c1 &= ~bit;
+    return true;
+  }
+
+  /**
+   * @brief Amostra as entradas se um tick tiver passado e chama as callbacks dos pinos que mudaram.
+   * @return Máscara dos pinos que mudaram (0 se nada mudou ou o tick ainda não venceu).
+   */
+  uint64_t update() {
+    unsigned long now = clockUs();
+    if (now - _lastTick < _tickUs) return 0;
+    _lastTick = now;
+    return tick(_reader());
+  }
+
+  /**
+   * @brief Processa uma amostra já lida (um tick), chamando as callbacks dos pinos que mudaram.
+   * @return Máscara dos pinos que mudaram.
+   */
+  uint64_t tick(uint64_t sample) {
+    uint64_t changed = _vc.step(sample & _mask);
+    if (changed) {
+      for (uint8_t i = 0; i < _count; i++) {
+        const Entry_t &e = _entries[i];
+        if ((changed >> e.pin) & 1 && e.callback) e.callback(e.ctx, (_vc.state >> e.pin) & 1);
+      }
+    }
+    return changed;
+  }
+
+  /**
+   * @brief Estado estável de todos os pinos observados (bit n = GPIO n).
+   */
+  uint64_t state() const { return _vc.state; }
+
+  /**
+   * @brief Estado estável de um pino.
+   */
+  bool pinValue(uint8_t pin) const { return (_vc.state >> pin) & 1; }
+
+  /**
+   * @brief Substitui a função de leitura das entradas (para testes no host).
+   */
+  void setReader(uint64_t (*reader)()) { _reader = reader ? reader : readInputs; }
+
+  /**
+   * @brief Lê todas as entradas do ESP32 de uma vez (bit n = GPIO n).
+   */
+  static uint64_t readInputs() {
+#ifdef ARDUINO
+    return (uint64_t)REG_READ(GPIO_IN_REG) | ((uint64_t)(REG_READ(GPIO_IN1_REG) & 0xFF) << 32);
+#else
+    return 0;
+#endif
+  }
+
+private:
+#ifdef ARDUINO
+  static constexpr uint8_t INPUT_PULLDOWN_MODE = INPUT_PULLDOWN;
+#else
+  static constexpr uint8_t INPUT_PULLDOWN_MODE = 0;
+#endif
+
+  struct Entry_t {
+    uint8_t pin;
+    CallbackFunc callback;
+    void *ctx;
+  };
+
+  static unsigned long clockUs() {
+#ifdef ARDUINO
+    return micros();
+#else
+    using namespace std::chrono;
+    return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  dinVCounter_t _vc{0, 0, 0};
+  uint64_t _mask = 0;
+  unsigned long _tickUs;
+  unsigned long _lastTick = 0;
+  uint64_t (*_reader)() = readInputs;
+  Entry_t _entries[DINBANK_MAX];
+  uint8_t _count = 0;
+};
+
+#endif
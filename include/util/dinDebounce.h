@@ -2,6 +2,14 @@
 #define DIGITAL_IN_DEBOUNCE_H
 
 #include "Arduino.h"
+#include "jqueue.h"
+
+#ifndef DIN_EDGE_QUEUE
+/**
+ * @brief Número de bordas que a interrupção pode guardar entre duas chamadas de update().
+ */
+#define DIN_EDGE_QUEUE 16
+#endif
 
 /**
  * @brief Classe para leitura digital com debounce utilizando callback.
@@ -9,6 +17,12 @@
  * Permite configurar um pino digital com debounce, sem uso de interrupções.
  * Sempre que o estado estável do pino mudar, a função callback é invocada,
  * recebendo o novo status (true para HIGH, false para LOW).
+ *
+ * Com enableInterrupt(), uma interrupção de GPIO registra cada borda com o instante em
+ * micros() numa fila sem trava, e update() só trabalha quando há bordas pendentes ou um
+ * estado aguardando confirmação; com o pino parado, update() retorna quase de imediato.
+ * Como o debounce usa os instantes das bordas, um pulso mais longo que o debounce é
+ * reconhecido mesmo que o loop demore mais que o pulso inteiro.
  */
 class DigitalINDebounce
 {
@@ -51,6 +65,11 @@ public:
    */
   void update()
   {
+    if (_isr)
+    {
+      updateEdges();
+      return;
+    }
     // Lê o pino
     bool reading = digitalRead(_pin);
 
@@ -91,8 +110,130 @@ public:
   {
     _callback = callback;
   }
+  /**
+   * @brief Recebe um estado já filtrado por outro debouncer (ex.: DinBank_c).
+   *
+   * Nesse uso update() não precisa ser chamada. A callback é chamada se o estado mudou.
+   * @param state Novo estado estável do pino.
+   */
+  void setStableState(bool state)
+  {
+    _currentState = state;
+    if (_stableState == state) return;
+    _stableState = state;
+    if (_callback != nullptr)
+    {
+      _callback(_stableState);
+    }
+  }
+  /**
+   * @brief Passa a capturar as bordas do pino por interrupção (CHANGE).
+   *
+   * Deve ser chamada depois de setup(). Com a interrupção ativa, update() continua sendo a
+   * função que confirma o estado e chama a callback, mas quase não custa nada com o pino parado.
+   */
+  void enableInterrupt()
+  {
+    if (_isr) return;
+    _edges.clear();
+    _overflow = false;
+    _currentState = digitalRead(_pin);
+    _lastEdgeUs = micros();
+    _isr = true;
+    attachInterruptArg(digitalPinToInterrupt(_pin), isrHandler, this, CHANGE);
+  }
+  /**
+   * @brief Volta ao modo por varredura (polling).
+   */
+  void disableInterrupt()
+  {
+    if (!_isr) return;
+    detachInterrupt(digitalPinToInterrupt(_pin));
+    _isr = false;
+    _lastDebounceTime = millis();
+  }
+  /**
+   * @brief Número de vezes que a fila de bordas encheu (o estado foi então relido do pino).
+   */
+  uint32_t edgeOverflows() const
+  {
+    return _overflows;
+  }
 
 private:
+  /**
+   * @brief Borda registrada pela interrupção.
+   */
+  struct Edge_t
+  {
+    unsigned long us; // Instante da borda (micros())
+    bool level;       // Nível lido logo após a borda
+  };
+
+  /**
+   * @brief Interrupção de GPIO: só registra a borda.
+   */
+  static void IRAM_ATTR isrHandler(void *arg)
+  {
+    DigitalINDebounce *self = (DigitalINDebounce *)arg;
+    if (!self->_edges.sendFromISR(Edge_t{micros(), (bool)digitalRead(self->_pin)}))
+      self->_overflow = true;
+  }
+
+  /**
+   * @brief Confirma o estado atual se ele já durou o tempo de debounce até o instante until.
+   */
+  void commitIfStable(unsigned long until)
+  {
+    if (_stableState != _currentState && (until - _lastEdgeUs) >= _debounceDelay * 1000UL)
+    {
+      _stableState = _currentState;
+      if (_callback != nullptr)
+      {
+        _callback(_stableState);
+      }
+    }
+  }
+
+  /**
+   * @brief update() no modo por interrupção: processa as bordas em ordem e depois o tempo atual.
+   */
+  void updateEdges()
+  {
+    Edge_t edge;
+    bool any = false;
+    while (_edges.receive(edge))
+    {
+      any = true;
+      if (edge.level == _currentState) continue; // repique que voltou antes da leitura
+      commitIfStable(edge.us);                   // o nível anterior durou o suficiente?
+      _currentState = edge.level;
+      _lastEdgeUs = edge.us;
+    }
+    if (_overflow)
+    {
+      // Bordas perdidas: a fila não é mais confiável, relê o pino e recomeça a contagem.
+      _overflow = false;
+      _overflows++;
+      _edges.clear();
+      bool level = digitalRead(_pin);
+      if (level != _currentState)
+      {
+        _currentState = level;
+        _lastEdgeUs = micros();
+      }
+      any = true;
+    }
+    if (!any && _stableState == _currentState) return; // nada pendente
+    commitIfStable(micros());
+  }
+
+  JQueue<Edge_t, DIN_EDGE_QUEUE> _edges; // Bordas registradas pela interrupção
+  volatile bool _overflow = false;       // A interrupção encontrou a fila cheia
+  uint32_t _overflows = 0;               // Número de estouros da fila
+  unsigned long _lastEdgeUs = 0;         // Instante da última borda aceita (modo interrupção)
+  bool _isr = false;                     // Modo por interrupção ativo
+
   uint8_t _pin;                    // Número do pino de leitura
   unsigned long _debounceDelay;    // Tempo de debounce em milissegundos
   bool _currentState;              // Última leitura instantânea do pino
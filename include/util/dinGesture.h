@@ -0,0 +1,250 @@
+#ifndef __DINGESTURE_H
+#define __DINGESTURE_H
+
+/**
+ * @file dinGesture.h
+ * @brief Gestos de botão (clique, duplo clique, pressão longa, repetição) sobre entradas com debounce.
+ *
+ * DinGesture_c recebe as mudanças de estado já filtradas (de DinBank_c ou de callbacks de
+ * DigitalINDebounce) e gera eventos tipados com o instante em microssegundos numa JQueue,
+ * que a aplicação esvazia em lotes:
+ *
+ *   DinGesture_c gestos;
+ *   gestos.bind(0, def_pin_PUSH1);
+ *   loop() {
+ *     IIKit.loop();                        // já chama IIKit.inputs.update()
+ *     gestos.feedMask(IIKit.inputsChanged(), IIKit.inputs.state(), micros());
+ *     gestos.poll(micros());
+ *     dinEvent_t ev[8];
+ *     for (uint32_t i = 0, n = gestos.events.receiveN(ev, 8); i < n; i++) trata(ev[i]);
+ *   }
+ *
+ * Com IIKIT_DIN_INTERRUPT 1 os botões não passam pelo banco; nesse caso chame edge() a
+ * partir das callbacks de DigitalINDebounce.
+ *
+ * A temporização só é avaliada para as entradas ativas (pressionadas ou aguardando um
+ * possível duplo clique); com tudo solto poll() retorna imediatamente. Nada aqui lê o
+ * relógio: os instantes vêm de quem chama, o que permite testar no host com sequências
+ * de bordas roteirizadas.
+ */
+
+#include "jqueue.h"
+
+#ifndef DIN_GESTURE_INPUTS
+/**
+ * @brief Número de entradas tratadas por um DinGesture_c (até 32).
+ */
+#define DIN_GESTURE_INPUTS 4
+#endif
+
+#ifndef DIN_GESTURE_QUEUE
+/**
+ * @brief Capacidade da fila de eventos (potência de 2).
+ */
+#define DIN_GESTURE_QUEUE 16
+#endif
+
+static_assert(DIN_GESTURE_INPUTS <= 32, "DIN_GESTURE_INPUTS deve ser no maximo 32");
+
+/**
+ * @brief Tipos de evento gerados.
+ */
+enum dinEventType_t : uint8_t {
+  DIN_PRESS,        ///< Entrada pressionada.
+  DIN_RELEASE,      ///< Entrada solta.
+  DIN_CLICK,        ///< Clique simples (emitido quando a janela de duplo clique expira; us = instante em que foi solto).
+  DIN_DOUBLE_CLICK, ///< Segundo clique dentro da janela.
+  DIN_LONG_PRESS,   ///< Mantida pressionada por longPressUs.
+  DIN_REPEAT        ///< Repetição automática enquanto mantida após a pressão longa.
+};
+
+/**
+ * @struct dinEvent_t
+ * @brief Evento de gesto.
+ *
+ * @param us Instante do evento (µs). PRESS, RELEASE e DOUBLE_CLICK: a borda que os gerou.
+ *           CLICK: a borda de soltura do clique, mesmo que ele só seja confirmado depois, ao
+ *           expirar a janela de duplo clique. LONG_PRESS e REPEAT: o instante nominal
+ *           (pressão + longPressUs, + n * repeatUs), não o da chamada de poll().
+ * @param input Índice da entrada.
+ * @param type Tipo do evento.
+ */
+struct dinEvent_t {
+  unsigned long us;
+  uint8_t input;
+  dinEventType_t type;
+};
+
+/**
+ * @struct dinGestureConfig_t
+ * @brief Tempos dos gestos (em microssegundos).
+ *
+ * @param doubleClickUs Janela entre soltar e pressionar de novo para duplo clique (0 = clique imediato).
+ * @param longPressUs Tempo pressionado para DIN_LONG_PRESS.
+ * @param repeatUs Intervalo de DIN_REPEAT após a pressão longa (0 = sem repetição).
+ */
+struct dinGestureConfig_t {
+  unsigned long doubleClickUs;
+  unsigned long longPressUs;
+  unsigned long repeatUs;
+};
+
+/**
+ * @class DinGesture_c
+ * @brief Máquina de gestos para até DIN_GESTURE_INPUTS entradas.
+ */
+class DinGesture_c {
+public:
+  /**
+   * @brief Fila de eventos; a aplicação consome com receive()/receiveN().
+   */
+  JQueue<dinEvent_t, DIN_GESTURE_QUEUE> events;
+
+  /**
+   * @brief Tempos em uso (podem ser alterados a qualquer momento).
+   */
+  dinGestureConfig_t config = {300000UL, 800000UL, 150000UL};
+
+  /**
+   * @brief Associa uma entrada a um GPIO, para uso com feedMask().
+   * @param input Índice da entrada (0 a DIN_GESTURE_INPUTS-1).
+   * @param pin GPIO correspondente (bit na máscara de DinBank_c).
+   * @param activeLow true se a entrada estiver pressionada em nível baixo.
+   */
+  bool bind(uint8_t input, uint8_t pin, bool activeLow = false) {
+    if (input >= DIN_GESTURE_INPUTS || pin > 63) return false;
+    _pin[input] = pin;
+    _activeLow = (_activeLow & ~(1UL << input)) | ((uint32_t)activeLow << input);
+    _bound |= 1UL << input;
+    return true;
+  }
+
+  /**
+   * @brief Repassa as mudanças de um DinBank_c (máscara de pinos que mudaram e estado atual).
+   * @param changed Máscara retornada por DinBank_c::update().
+   * @param state Estado estável de todos os pinos (DinBank_c::state()).
+   * @param us Instante da mudança.
+   */
+  void feedMask(uint64_t changed, uint64_t state, unsigned long us) {
+    if (!changed) return;
+    for (uint8_t i = 0; i < DIN_GESTURE_INPUTS; i++) {
+      if (!((_bound >> i) & 1) || !((changed >> _pin[i]) & 1)) continue;
+      bool level = (state >> _pin[i]) & 1;
+      edge(i, level != (bool)((_activeLow >> i) & 1), us);
+    }
+  }
+
+  /**
+   * @brief Informa uma mudança de estado (já com debounce) de uma entrada.
+   * @param input Índice da entrada.
+   * @param pressed true ao pressionar, false ao soltar.
+   * @param us Instante da mudança.
+   */
+  void edge(uint8_t input, bool pressed, unsigned long us) {
+    if (input >= DIN_GESTURE_INPUTS) return;
+    Input_t &s = _in[input];
+    uint32_t bit = 1UL << input;
+    if (pressed == (bool)(_pressed & bit)) return;
+    if (pressed) {
+      _pressed |= bit;
+      _active |= bit;
+      s.pressUs = us;
+      s.longFired = false;
+      // Segundo toque dentro da janela: o clique pendente vira duplo ao soltar.
+      s.second = s.clickPending && (us - s.releaseUs) <= config.doubleClickUs;
+      if (s.clickPending && !s.second) {
+        emit(input, DIN_CLICK, s.releaseUs);
+        s.clickPending = false;
+      }
+      emit(input, DIN_PRESS, us);
+    } else {
+      _pressed &= ~bit;
+      emit(input, DIN_RELEASE, us);
+      if (s.longFired) {
+        s.clickPending = false;
+      } else if (s.second) {
+        emit(input, DIN_DOUBLE_CLICK, us);
+        s.clickPending = false;
+      } else if (config.doubleClickUs == 0) {
+        emit(input, DIN_CLICK, us);
+      } else {
+        s.clickPending = true;
+        s.releaseUs = us;
+      }
+      s.second = false;
+      if (!s.clickPending) _active &= ~bit;
+    }
+  }
+
+  /**
+   * @brief Avalia os eventos de tempo (clique confirmado, pressão longa, repetição).
+   *
+   * Só percorre as entradas ativas; chame a cada passagem do loop.
+   * @param now Instante atual (µs), no mesmo relógio das bordas.
+   */
+  void poll(unsigned long now) {
+    uint32_t active = _active;
+    while (active) {
+      uint8_t i = __builtin_ctz(active);
+      active &= active - 1;
+      Input_t &s = _in[i];
+      uint32_t bit = 1UL << i;
+      if (_pressed & bit) {
+        if (!s.longFired) {
+          if (now - s.pressUs < config.longPressUs) continue;
+          if (s.clickPending) { // primeiro clique seguido de pressão longa
+            emit(i, DIN_CLICK, s.releaseUs);
+            s.clickPending = false;
+            s.second = false;
+          }
+          s.longFired = true;
+          s.nextRepeatUs = s.pressUs + config.longPressUs + config.repeatUs;
+          emit(i, DIN_LONG_PRESS, s.pressUs + config.longPressUs);
+        }
+        if (config.repeatUs && (long)(now - s.nextRepeatUs) >= 0) {
+          emit(i, DIN_REPEAT, s.nextRepeatUs);
+          // Um evento por passagem; repetições perdidas num loop lento são puladas.
+          s.nextRepeatUs += ((now - s.nextRepeatUs) / config.repeatUs + 1) * config.repeatUs;
+        }
+      } else if (s.clickPending && now - s.releaseUs > config.doubleClickUs) {
+        emit(i, DIN_CLICK, s.releaseUs);
+        s.clickPending = false;
+        _active &= ~bit;
+      }
+    }
+  }
+
+  /**
+   * @brief Indica se a entrada está pressionada.
+   */
+  bool isPressed(uint8_t input) const { return (_pressed >> input) & 1; }
+
+  /**
+   * @brief Número de eventos descartados por fila cheia.
+   */
+  uint32_t dropped() const { return _dropped; }
+
+private:
+  struct Input_t {
+    unsigned long pressUs;      ///< Instante em que foi pressionada.
+    unsigned long releaseUs;    ///< Instante em que foi solta (clique pendente).
+    unsigned long nextRepeatUs; ///< Próxima repetição.
+    bool clickPending;          ///< Clique aguardando a janela de duplo clique.
+    bool second;                ///< Pressão atual é o segundo toque de um duplo clique.
+    bool longFired;             ///< Pressão longa já emitida nesta pressão.
+  };
+
+  void emit(uint8_t input, dinEventType_t type, unsigned long us) {
+    if (!events.send(dinEvent_t{us, input, type})) _dropped++;
+  }
+
+  Input_t _in[DIN_GESTURE_INPUTS] = {};
+  uint8_t _pin[DIN_GESTURE_INPUTS] = {};
+  uint32_t _pressed = 0;   ///< Entradas pressionadas.
+  uint32_t _active = 0;    ///< Entradas com temporização pendente.
+  uint32_t _bound = 0;     ///< Entradas associadas a um GPIO.
+  uint32_t _activeLow = 0; ///< Entradas ativas em nível baixo.
+  uint32_t _dropped = 0;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef __FBBACKEND_H
+#define __FBBACKEND_H
+
+/**
+ * @file fbBackend.h
+ * @brief Destino de renderização de um framebuffer em páginas (interface e backend em memória).
+ *
+ * FbBackend_c fornece o framebuffer onde o desenho é feito (buffer()) e recebe as janelas
+ * alteradas (write()), contando quantas janelas e bytes de framebuffer seriam enviados. O
+ * backend do SSD1306 por I2C fica em services/displaySSD1306.h; FbMemory_c guarda as janelas
+ * recebidas numa cópia da RAM do controlador, sem hardware, e grava quadros em PBM para
+ * inspeção.
+ *
+ * Uso no host:
+ *   FbMemory_c mem;
+ *   disp.setBackend(&mem);
+ *   ... disp.update(); ...
+ *   mem.savePBM("quadro.pbm");
+ *   printf("%u bytes\n", mem.bytes());
+ */
+
+#include "fbDirty.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+/**
+ * @class FbBackend_c
+ * @brief Interface de destino de renderização.
+ */
+class FbBackend_c {
+public:
+  virtual ~FbBackend_c() {}
+
+  /**
+   * @brief Inicializa o destino.
+   * @return false em caso de falha.
+   */
+  virtual bool begin() = 0;
+
+  /**
+   * @brief Framebuffer de desenho (FB_WIDTH * FB_PAGES bytes, válido após begin()).
+   */
+  virtual uint8_t *buffer() = 0;
+
+  /**
+   * @brief Envia a janela páginas page0..page1, colunas x0..x1 de fb e atualiza os contadores.
+   */
+  void write(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) {
+    _windows.fetch_add(1, std::memory_order_relaxed);
+    _bytes.fetch_add((uint32_t)(page1 - page0 + 1) * (x1 - x0 + 1), std::memory_order_relaxed);
+    writeRegion(page0, page1, x0, x1, fb);
+  }
+
+  /**
+   * @brief Bytes de framebuffer enviados (sem o custo dos comandos de endereçamento).
+   */
+  uint32_t bytes() const { return _bytes.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Janelas (páginas × colunas) enviadas; cada uma custa um comando de endereçamento.
+   */
+  uint32_t windows() const { return _windows.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Zera os contadores.
+   */
+  void resetCounters() {
+    _bytes.store(0, std::memory_order_relaxed);
+    _windows.store(0, std::memory_order_relaxed);
+  }
+
+protected:
+  /**
+   * @brief Envio propriamente dito (implementado por cada backend).
+   */
+  virtual void writeRegion(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) = 0;
+
+private:
+  std::atomic<uint32_t> _bytes{0};
+  std::atomic<uint32_t> _windows{0};
+};
+
+/**
+ * @class FbMemory_c
+ * @brief Backend em memória: simula a RAM do controlador e grava quadros em PBM.
+ */
+class FbMemory_c : public FbBackend_c {
+public:
+  bool begin() override {
+    memset(_draw, 0, sizeof(_draw));
+    memset(_ram, 0, sizeof(_ram));
+    return true;
+  }
+
+  uint8_t *buffer() override { return _draw; }
+
+  /**
+   * @brief Conteúdo que o display estaria mostrando (mesmo layout do framebuffer).
+   */
+  const uint8_t *ram() const { return _ram; }
+
+  /**
+   * @brief Pixel aceso na RAM simulada.
+   */
+  bool pixel(uint8_t x, uint8_t y) const {
+    if (x >= FB_WIDTH || y >= FB_HEIGHT) return false;
+    return (_ram[x + (y >> 3) * FB_WIDTH] >> (y & 7)) & 1;
+  }
+
+  /**
+   * @brief Grava a RAM simulada em PBM binário (P4); pixels acesos saem pretos.
+   * @return false em caso de erro de escrita.
+   */
+  bool writePBM(FILE *file) const {
+    if (fprintf(file, "P4\n%d %d\n", FB_WIDTH, FB_HEIGHT) < 0) return false;
+    uint8_t row[(FB_WIDTH + 7) / 8];
+    for (uint8_t y = 0; y < FB_HEIGHT; y++) {
+      memset(row, 0, sizeof(row));
+      for (uint16_t x = 0; x < FB_WIDTH; x++)
+        if (pixel(x, y)) row[x >> 3] |= 0x80 >> (x & 7);
+      if (fwrite(row, 1, sizeof(row), file) != sizeof(row)) return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Grava a RAM simulada num arquivo PBM.
+   */
+  bool savePBM(const char *path) const {
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = writePBM(file);
+    return fclose(file) == 0 && ok;
+  }
+
+protected:
+  void writeRegion(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) override {
+    for (uint8_t p = page0; p <= page1; p++)
+      memcpy(_ram + p * FB_WIDTH + x0, fb + p * FB_WIDTH + x0, x1 - x0 + 1);
+  }
+
+private:
+  uint8_t _draw[FB_WIDTH * FB_PAGES];
+  uint8_t _ram[FB_WIDTH * FB_PAGES];
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef __FBDIRTY_H
+#define __FBDIRTY_H
+
+/**
+ * @file fbDirty.h
+ * @brief Regiões alteradas de um framebuffer monocromático organizado em páginas (SSD1306).
+ *
+ * No SSD1306 cada byte do framebuffer é uma coluna de 8 pixels, e uma página é uma faixa de
+ * 8 linhas com FB_WIDTH bytes (fb[x + página * FB_WIDTH], bit y & 7). fbDirty_t guarda, para
+ * cada página, o intervalo de colunas alterado desde o último envio, que é exatamente o que
+ * o endereçamento por página/coluna do controlador permite enviar.
+ */
+
+#include <stdint.h>
+
+#ifndef FB_WIDTH
+#define FB_WIDTH 128 ///< Largura do framebuffer em pixels (até 256).
+#endif
+#ifndef FB_HEIGHT
+#define FB_HEIGHT 64 ///< Altura do framebuffer em pixels (múltiplo de 8).
+#endif
+#define FB_PAGES (FB_HEIGHT / 8) ///< Número de páginas de 8 linhas.
+
+static_assert(FB_WIDTH <= 256 && FB_HEIGHT % 8 == 0, "framebuffer deve ter ate 256 colunas e altura multipla de 8");
+
+/**
+ * @struct fbDirty_t
+ * @brief Intervalo de colunas alterado em cada página (vazio quando x0 > x1).
+ */
+struct fbDirty_t {
+  uint8_t x0[FB_PAGES]; ///< Primeira coluna alterada.
+  uint8_t x1[FB_PAGES]; ///< Última coluna alterada (inclusiva).
+
+  fbDirty_t() { clear(); }
+
+  /**
+   * @brief Marca tudo como limpo.
+   */
+  void clear() {
+    for (uint8_t p = 0; p < FB_PAGES; p++) {
+      x0[p] = 0xFF;
+      x1[p] = 0;
+    }
+  }
+
+  /**
+   * @brief Marca a tela inteira como alterada.
+   */
+  void markAll() { mark(0, 0, FB_WIDTH, FB_HEIGHT); }
+
+  /**
+   * @brief Marca um retângulo como alterado (recortado à tela).
+   */
+  void mark(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > FB_WIDTH) w = FB_WIDTH - x;
+    if (y + h > FB_HEIGHT) h = FB_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+    for (uint8_t p = y / 8; p <= (y + h - 1) / 8; p++) {
+      if (x < x0[p]) x0[p] = x;
+      if (x + w - 1 > x1[p]) x1[p] = x + w - 1;
+    }
+  }
+
+  /**
+   * @brief Acrescenta as regiões de outro conjunto.
+   */
+  void merge(const fbDirty_t &other) {
+    for (uint8_t p = 0; p < FB_PAGES; p++) {
+      if (other.x0[p] > other.x1[p]) continue;
+      if (other.x0[p] < x0[p]) x0[p] = other.x0[p];
+      if (other.x1[p] > x1[p]) x1[p] = other.x1[p];
+    }
+  }
+
+  /**
+   * @brief Indica se há alguma região alterada.
+   */
+  bool any() const {
+    for (uint8_t p = 0; p < FB_PAGES; p++)
+      if (x0[p] <= x1[p]) return true;
+    return false;
+  }
+
+  /**
+   * @brief Número de bytes de framebuffer a enviar.
+   */
+  uint32_t bytes() const {
+    uint32_t n = 0;
+    for (uint8_t p = 0; p < FB_PAGES; p++)
+      if (x0[p] <= x1[p]) n += x1[p] - x0[p] + 1;
+    return n;
+  }
+
+  /**
+   * @brief Percorre as regiões alteradas, juntando páginas vizinhas com o mesmo intervalo.
+   * @param fn Chamada como fn(página0, página1, x0, x1) para cada janela retangular.
+   */
+  template <typename F>
+  void forEachRun(F fn) const {
+    uint8_t p = 0;
+    while (p < FB_PAGES) {
+      if (x0[p] > x1[p]) {
+        p++;
+        continue;
+      }
+      uint8_t last = p;
+      while (last + 1 < FB_PAGES && x0[last + 1] == x0[p] && x1[last + 1] == x1[p]) last++;
+      fn(p, last, x0[p], x1[p]);
+      p = last + 1;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef __FBRENDERER_H
+#define __FBRENDERER_H
+
+/**
+ * @file fbRenderer.h
+ * @brief Envio do framebuffer em segundo plano, com buffer duplo.
+ *
+ * O código de desenho continua escrevendo no framebuffer de trás (back) e marcando as
+ * regiões alteradas; commit() só junta essas regiões às pendentes e retorna. Uma task
+ * própria, na taxa de quadros configurada, faz a troca (flip): copia para o buffer da frente
+ * (front) apenas as regiões alteradas e as envia pelo transporte, fora da trava. Assim o
+ * tempo de I2C não aparece mais no loop principal.
+ *
+ * Quem desenha deve segurar lock()/unlock() enquanto altera o buffer de trás; a task só
+ * segura a trava durante a cópia (no máximo FB_WIDTH * FB_PAGES bytes).
+ *
+ * No ESP32 a task é FreeRTOS (xTaskCreatePinnedToCore); fora do Arduino é uma std::thread.
+ * frame() executa um quadro manualmente, para testar a troca no host com um transporte falso.
+ *
+ * Uso:
+ *   FbRenderer_c renderer;
+ *   renderer.begin(back, enviaRegiao, nullptr, 25);
+ *   loop() {
+ *     renderer.lock(); desenha(back, dirty); renderer.commit(dirty); renderer.unlock();
+ *   }
+ */
+
+#include "fbDirty.h"
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <thread>
+#include <chrono>
+#endif
+
+#ifndef FB_RENDERER_STACK
+/**
+ * @brief Tamanho da pilha da task de envio no ESP32 (bytes).
+ */
+#define FB_RENDERER_STACK 3072
+#endif
+
+/**
+ * @brief Transporte: envia a janela páginas page0..page1, colunas x0..x1 do framebuffer fb.
+ */
+typedef void (*fbTransport_t)(void *ctx, uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb);
+
+/**
+ * @class FbRenderer_c
+ * @brief Buffer da frente, troca por regiões alteradas e task de envio.
+ */
+class FbRenderer_c {
+public:
+  FbRenderer_c() = default;
+  FbRenderer_c(const FbRenderer_c &) = delete;
+  FbRenderer_c &operator=(const FbRenderer_c &) = delete;
+  ~FbRenderer_c() { end(); }
+
+  /**
+   * @brief Configura o renderizador e inicia a task de envio.
+   * @param back Framebuffer de trás (FB_WIDTH * FB_PAGES bytes), onde o desenho é feito.
+   * @param transport Função que envia uma janela do buffer da frente.
+   * @param ctx Contexto repassado ao transporte.
+   * @param fps Taxa de quadros (0 = não cria a task; os quadros são feitos com frame()). No
+   *            ESP32 o período é de pelo menos um tick do FreeRTOS, então a taxa efetiva não
+   *            passa de configTICK_RATE_HZ (100 Hz no Arduino).
+   * @param core Núcleo da task no ESP32.
+   * @param priority Prioridade FreeRTOS da task no ESP32.
+   * @return false se a task não pôde ser criada.
+   */
+  bool begin(const uint8_t *back, fbTransport_t transport, void *ctx, uint16_t fps = 25, uint8_t core = 0, uint8_t priority = 1) {
+    end();
+    _back = back;
+    _transport = transport;
+    _ctx = ctx;
+    // O buffer da frente começa igual ao de trás e tudo pendente: o primeiro quadro envia a tela inteira.
+    memcpy(_front, back, sizeof(_front));
+    _pending.clear();
+    _frontDirty.markAll();
+    if (!fps) return true;
+    _periodMs = 1000 / fps ? 1000 / fps : 1;
+    _running.store(true);
+#ifdef ARDUINO
+    _taskAlive.store(true);
+    if (xTaskCreatePinnedToCore(task, "fb_render", FB_RENDERER_STACK, this, priority, nullptr, core % portNUM_PROCESSORS) != pdPASS) {
+      _taskAlive.store(false);
+      _running.store(false);
+      return false;
+    }
+#else
+    (void)core;
+    (void)priority;
+    _thread = std::thread(task, this);
+#endif
+    return true;
+  }
+
+  /**
+   * @brief Para a task de envio (espera o quadro em andamento terminar).
+   */
+  void end() {
+    if (!_running.exchange(false)) return;
+#ifdef ARDUINO
+    while (_taskAlive.load()) vTaskDelay(1);
+#else
+    if (_thread.joinable()) _thread.join();
+#endif
+  }
+
+  /**
+   * @brief Indica se a task de envio está ativa.
+   */
+  bool running() const { return _running.load(); }
+
+  /**
+   * @brief Trava o buffer de trás para desenho.
+   */
+  void lock() { _mtx.lock(); }
+
+  /**
+   * @brief Libera o buffer de trás.
+   */
+  void unlock() { _mtx.unlock(); }
+
+  /**
+   * @brief Entrega as regiões desenhadas no buffer de trás (com lock() seguro) e as limpa em dirty.
+   */
+  void commit(fbDirty_t &dirty) {
+    _pending.merge(dirty);
+    dirty.clear();
+  }
+
+  /**
+   * @brief Troca: copia as regiões pendentes do buffer de trás para o da frente.
+   * @return true se havia algo a copiar.
+   */
+  bool flip() {
+    std::lock_guard<std::mutex> guard(_mtx);
+    if (!_pending.any()) return false;
+    _pending.forEachRun([this](uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1) {
+      for (uint8_t p = page0; p <= page1; p++)
+        memcpy(_front + p * FB_WIDTH + x0, _back + p * FB_WIDTH + x0, x1 - x0 + 1);
+    });
+    _frontDirty.merge(_pending);
+    _pending.clear();
+    return true;
+  }
+
+  /**
+   * @brief Envia as regiões alteradas do buffer da frente (sem trava).
+   * @return Bytes de framebuffer enviados.
+   */
+  uint32_t flush() {
+    if (!_frontDirty.any() || !_transport) return 0;
+    uint32_t bytes = _frontDirty.bytes();
+    _frontDirty.forEachRun([this](uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1) {
+      _transport(_ctx, page0, page1, x0, x1, _front);
+    });
+    _frontDirty.clear();
+    _frames++;
+    _bytes += bytes;
+    return bytes;
+  }
+
+  /**
+   * @brief Um quadro: flip() seguido de flush().
+   * @return Bytes enviados.
+   */
+  uint32_t frame() {
+    flip();
+    return flush();
+  }
+
+  /**
+   * @brief Buffer da frente (o que está, ou está indo, para o display).
+   */
+  const uint8_t *front() const { return _front; }
+
+  /**
+   * @brief Quadros enviados (só os que tinham alterações).
+   */
+  uint32_t frames() const { return _frames; }
+
+  /**
+   * @brief Total de bytes de framebuffer enviados.
+   */
+  uint32_t bytes() const { return _bytes; }
+
+private:
+  static void task(void *arg) {
+    FbRenderer_c *self = (FbRenderer_c *)arg;
+#ifdef ARDUINO
+    // Com fps acima da taxa de ticks pdMS_TO_TICKS daria 0 e a task nunca cederia o núcleo.
+    TickType_t period = pdMS_TO_TICKS(self->_periodMs);
+    if (period == 0) period = 1;
+    TickType_t last = xTaskGetTickCount();
+    while (self->_running.load()) {
+      vTaskDelayUntil(&last, period);
+      self->frame();
+    }
+    self->_taskAlive.store(false);
+    vTaskDelete(nullptr);
+#else
+    auto next = std::chrono::steady_clock::now();
+    while (self->_running.load()) {
+      next += std::chrono::milliseconds(self->_periodMs);
+      std::this_thread::sleep_until(next);
+      self->frame();
+    }
+#endif
+  }
+
+  uint8_t _front[FB_WIDTH * FB_PAGES];
+  const uint8_t *_back = nullptr;
+  fbDirty_t _pending;    ///< Alterado no buffer de trás e ainda não copiado.
+  fbDirty_t _frontDirty; ///< Copiado para a frente e ainda não enviado.
+  fbTransport_t _transport = nullptr;
+  void *_ctx = nullptr;
+  std::mutex _mtx;
+  std::atomic<bool> _running{false};
+  uint32_t _periodMs = 40;
+  uint32_t _frames = 0;
+  uint32_t _bytes = 0;
+#ifdef ARDUINO
+  std::atomic<bool> _taskAlive{false};
+#else
+  std::thread _thread;
+#endif
+};
+
+#endif
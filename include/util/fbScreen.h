@@ -0,0 +1,418 @@
+#ifndef __FBSCREEN_H
+#define __FBSCREEN_H
+
+/**
+ * @file fbScreen.h
+ * @brief Tela de três linhas de texto com rolagem, desenhada sobre um FbBackend_c.
+ *
+ * FbScreen_c guarda todo o estado de desenho do display (textos, rolagem, faixas em cache,
+ * gráfico de tendência, regiões alteradas, envio em segundo plano e medidas) e só conversa
+ * com o hardware pelo backend: desenha em backend->buffer() e envia as janelas alteradas com
+ * backend->write(). Não depende do Arduino, então a mesma lógica roda no host sobre o
+ * FbMemory_c, para testes e medidas de desempenho.
+ *
+ * Só as linhas alteradas (ou em rolagem) são redesenhadas, e só as páginas/colunas que elas
+ * ocupam são enviadas. A rolagem depende do tempo (pixels por segundo, setScroll()): update()
+ * só desenha quando um quadro de rolagem vence ou algo mudou, e retorna de imediato nos
+ * demais casos. Cada linha é rasterizada uma única vez, quando o texto muda, numa faixa
+ * (fbStrip_t); linhas que não cabem numa faixa são rasterizadas a cada quadro.
+ *
+ * A rasterização é feita por um fbRasterizer_t: por padrão a fonte embutida de fbText.h; o
+ * Display_c do SSD1306 instala o Adafruit_GFX (services/displaySSD1306.h).
+ *
+ * Uso no host:
+ *   FbMemory_c mem;
+ *   FbScreen_c screen(&mem);
+ *   screen.begin();
+ *   screen.setText(1, "Linha longa que rola");
+ *   for (unsigned long t = 0; t < 1000000; t += 40000) screen.update(t);
+ *   mem.savePBM("quadro.pbm");
+ */
+
+#include "fbDirty.h"
+#include "fbRenderer.h"
+#include "fbText.h"
+#include "fbTrend.h"
+#include "fbBackend.h"
+#include <string.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Rasterizador: desenha text em rows (formato GFXcanvas1, w × h) a partir da coluna x.
+ * @return false se não conseguiu desenhar (ex.: falta de memória).
+ */
+typedef bool (*fbRasterizer_t)(uint8_t *rows, uint16_t w, uint8_t h, int16_t x, const char *text, uint8_t size);
+
+/**
+ * @brief Relógio em microssegundos usado por update() sem argumento e pelas medidas.
+ */
+inline unsigned long fbScreenMicros() {
+#ifdef ARDUINO
+  return micros();
+#else
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @struct displayStats_t
+ * @brief Medidas de renderização de FbScreen_c.
+ *
+ * @param frames Quadros renderizados (chamadas de update() que desenharam algo).
+ * @param renderUs Tempo total de renderização (µs), sem o envio quando startRenderer() está ativo.
+ * @param maxRenderUs Maior tempo de renderização de um quadro (µs).
+ * @param bytes Bytes de framebuffer enviados pelo backend.
+ * @param windows Janelas de endereçamento enviadas pelo backend.
+ */
+struct displayStats_t {
+  uint32_t frames;
+  uint32_t renderUs;
+  uint32_t maxRenderUs;
+  uint32_t bytes;
+  uint32_t windows;
+};
+
+/**
+ * @class FbScreen_c
+ * @brief Estado e desenho das três linhas de texto, independente do hardware.
+ */
+class FbScreen_c {
+protected:
+  /**
+   * @brief Desenha a linha especificada (na posição de rolagem atual, se for longa).
+   * @param index Índice da linha.
+   */
+  void rotaty(uint8_t index);
+
+  /**
+   * @brief Avança a rolagem de uma linha, invertendo o sentido nas extremidades.
+   * @param index Índice da linha.
+   * @param px Número de pixels a avançar.
+   */
+  void scrollBy(uint8_t index, uint32_t px);
+
+  /**
+   * @brief Rasteriza o texto da linha na faixa em cache.
+   * @param index Índice da linha.
+   */
+  void cacheLine(uint8_t index);
+
+  /**
+   * @brief Apaga a área ocupada pela última renderização da linha.
+   * @param index Índice da linha.
+   */
+  void clearLine(uint8_t index);
+
+  /**
+   * @brief Envia ao backend somente as regiões alteradas.
+   */
+  void flush(void);
+
+  uint8_t ui8_changedLines = 0x07; ///< Linhas alteradas desde a última renderização (bit n = linha n).
+  uint8_t ui8_drawnWidth[3] = {0, 0, 0}; ///< Colunas ocupadas pela última renderização de cada linha.
+  uint8_t ui8_drawnHeight[3] = {0, 0, 0}; ///< Altura ocupada pela última renderização de cada linha.
+  fbDirty_t dirty; ///< Regiões do framebuffer ainda não enviadas.
+  FbRenderer_c renderer; ///< Envio em segundo plano (ativo após startRenderer()).
+  bool scrollLeft[3] = {false, false, false}; ///< Flags de rolagem para cada linha.
+  char ca_lineTxt[3][20] = {"Inicializando...", "", ""}; ///< Conteúdo das linhas do display.
+  uint8_t ui8_lineSize[3] = {16, 0, 0}; ///< Tamanho do texto de cada linha.
+  uint8_t ui8_txtSize[3] = {2, 2, 2}; ///< Tamanho da fonte para cada linha.
+  int16_t i16_lineWidth[3] = {12, 12, 12}; ///< Largura inicial do texto em cada linha.
+  int16_t i16_lineMinWidth[3] = {-84, 108, 108}; ///< Largura mínima para rolagem do texto.
+  uint16_t ui16_scrollSpeed = 40; ///< Velocidade de rolagem em pixels por segundo.
+  uint32_t ui32_frameUs = 40000; ///< Intervalo mínimo entre quadros de rolagem (µs).
+  unsigned long ul_lastFrameUs = 0; ///< Instante do último quadro de rolagem.
+  uint32_t ui32_scrollRem = 0; ///< Fração de pixel acumulada (em pixels × µs).
+  fbStrip_t strips[3] = {}; ///< Texto de cada linha já rasterizado (height = 0: sem cache).
+  FbTrend_c *trend = nullptr; ///< Gráfico de tendência (opcional).
+  FbBackend_c *backend; ///< Destino da renderização.
+  FbBackend_c *defaultBackend; ///< Backend restaurado por setBackend(nullptr).
+  fbRasterizer_t rasterizer; ///< Rasterização do texto.
+  uint32_t ui32_frames = 0; ///< Quadros renderizados.
+  uint32_t ui32_renderUs = 0; ///< Tempo total de renderização (µs).
+  uint32_t ui32_maxRenderUs = 0; ///< Maior tempo de renderização de um quadro (µs).
+
+public:
+  /**
+   * @brief Construtor.
+   * @param target Backend padrão (pode ser trocado com setBackend()).
+   * @param raster Rasterizador de texto (nullptr: fonte embutida).
+   */
+  explicit FbScreen_c(FbBackend_c *target = nullptr, fbRasterizer_t raster = nullptr)
+      : backend(target), defaultBackend(target), rasterizer(raster ? raster : fbTextRows) {}
+
+  /**
+   * @brief Inicializa o backend, limpa o framebuffer e redesenha as três linhas.
+   * @return false se não houver backend ou se ele falhar.
+   */
+  bool begin(void);
+
+  /**
+   * @brief Configura o texto de uma linha.
+   * @param line Índice da linha (1 a 3).
+   * @param txt Texto a ser exibido (até 19 caracteres).
+   * @param txtSize Tamanho da fonte.
+   */
+  void setText(uint8_t line, const char txt[], uint8_t txtSize = 2);
+
+  /**
+   * @brief Desenha e envia o que estiver pendente, com o relógio fbScreenMicros().
+   */
+  void update(void);
+
+  /**
+   * @brief Como update(), mas com o instante (µs) dado por quem chama, para a rolagem.
+   *
+   * Permite simular o tempo no host; o tempo de renderização continua medido no relógio real.
+   */
+  void update(unsigned long now);
+
+  /**
+   * @brief Passa o envio ao backend para uma task em segundo plano.
+   *
+   * Deve ser chamada depois de begin().
+   * @param fps Taxa máxima de quadros enviados.
+   * @param core Núcleo da task.
+   * @return true se a task foi criada.
+   */
+  bool startRenderer(uint16_t fps = 25, uint8_t core = 0);
+
+  /**
+   * @brief Configura a rolagem das linhas longas.
+   * @param pxPerSec Velocidade em pixels por segundo.
+   * @param maxFps Taxa máxima de quadros de rolagem.
+   */
+  void setScroll(uint16_t pxPerSec, uint8_t maxFps = 25);
+
+  /**
+   * @brief Exibe um gráfico de tendência, desenhado incrementalmente a cada update().
+   *
+   * A região do gráfico não deve coincidir com linhas de texto não vazias.
+   * @param chart Gráfico (ou nullptr para remover). Deve receber amostras na mesma thread de update().
+   */
+  void setTrend(FbTrend_c *chart);
+
+  /**
+   * @brief Troca o destino da renderização (antes de begin()).
+   * @param target Backend (nullptr volta ao backend padrão).
+   */
+  void setBackend(FbBackend_c *target);
+
+  /**
+   * @brief Troca o rasterizador de texto (nullptr volta à fonte embutida).
+   */
+  void setRasterizer(fbRasterizer_t raster);
+
+  /**
+   * @brief Medidas de renderização e envio desde o início (ou desde resetStats()).
+   */
+  displayStats_t stats() const;
+
+  /**
+   * @brief Zera as medidas.
+   */
+  void resetStats(void);
+};
+
+bool FbScreen_c::begin(void) {
+  if (!backend || !backend->begin()) {
+    return false;
+  }
+  memset(backend->buffer(), 0, FB_WIDTH * FB_PAGES);
+  dirty.markAll();
+  for (uint8_t i = 0; i < 3; i++) {
+    setText(i + 1, ca_lineTxt[i], ui8_txtSize[i]);
+  }
+  return true;
+}
+
+void FbScreen_c::update(void) {
+  update(fbScreenMicros());
+}
+
+void FbScreen_c::update(unsigned long now) {
+  if (!backend) return;
+  uint8_t lines = ui8_changedLines;
+  uint8_t scrolling = 0;
+  for (uint8_t i = 0; i < 3; i++) {
+    if (ui8_lineSize[i] > 10) scrolling |= 1 << i;
+  }
+  if (!scrolling) {
+    ul_lastFrameUs = now;
+    ui32_scrollRem = 0;
+  } else if (now - ul_lastFrameUs >= ui32_frameUs) {
+    // Quadro de rolagem vencido: avança conforme o tempo decorrido, guardando a fração.
+    uint64_t acc = (uint64_t)(now - ul_lastFrameUs) * ui16_scrollSpeed + ui32_scrollRem;
+    uint32_t px = acc / 1000000UL;
+    ui32_scrollRem = acc % 1000000UL;
+    ul_lastFrameUs = now;
+    if (px) {
+      for (uint8_t i = 0; i < 3; i++) {
+        if ((scrolling >> i) & 1) scrollBy(i, px);
+      }
+      lines |= scrolling;
+    }
+  }
+  bool chart = trend && trend->pending();
+  if (!lines && !chart && !dirty.any()) return; // nenhum quadro devido
+  unsigned long t0 = fbScreenMicros();
+  bool async = renderer.running();
+  if (async) renderer.lock();
+  if (lines) {
+    // Linhas cujas faixas se sobrepõem a uma linha redesenhada também são redesenhadas.
+    for (uint8_t pass = 0; pass < 2; pass++) {
+      for (uint8_t i = 0; i < 3; i++) {
+        if (!((lines >> i) & 1)) continue;
+        for (uint8_t j = 0; j < 3; j++) {
+          uint8_t top = i < j ? i : j, bottom = i < j ? j : i;
+          uint8_t h = ui8_drawnHeight[top] > 8 * ui8_txtSize[top] ? ui8_drawnHeight[top] : 8 * ui8_txtSize[top];
+          if (i != j && top * 20 + h > bottom * 20) lines |= 1 << j;
+        }
+      }
+    }
+    ui8_changedLines = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+      if ((lines >> i) & 1) clearLine(i);
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+      if ((lines >> i) & 1) rotaty(i);
+    }
+  }
+  if (chart) trend->draw(backend->buffer(), dirty);
+  if (dirty.any()) flush();
+  if (async) renderer.unlock();
+  uint32_t elapsed = fbScreenMicros() - t0;
+  ui32_frames++;
+  ui32_renderUs += elapsed;
+  if (elapsed > ui32_maxRenderUs) ui32_maxRenderUs = elapsed;
+}
+
+void FbScreen_c::clearLine(uint8_t index) {
+  if (!ui8_drawnWidth[index] || !ui8_drawnHeight[index]) return;
+  fbClearRect(backend->buffer(), 0, index * 20, ui8_drawnWidth[index], ui8_drawnHeight[index]);
+  dirty.mark(0, index * 20, ui8_drawnWidth[index], ui8_drawnHeight[index]);
+  ui8_drawnWidth[index] = 0;
+}
+
+void FbScreen_c::flush(void) {
+  if (renderer.running()) {
+    renderer.commit(dirty); // a task copia e envia no próximo quadro
+    return;
+  }
+  FbBackend_c *target = backend;
+  const uint8_t *fb = target->buffer();
+  dirty.forEachRun([target, fb](uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1) {
+    target->write(page0, page1, x0, x1, fb);
+  });
+  dirty.clear();
+}
+
+void FbScreen_c::rotaty(uint8_t index) {
+  int16_t textWidth = 6 * ui8_txtSize[index] * ui8_lineSize[index];
+  int16_t x = ui8_lineSize[index] > 10 ? i16_lineWidth[index] : 0;
+  uint8_t h = 8 * ui8_txtSize[index] < FB_HEIGHT - index * 20 ? 8 * ui8_txtSize[index] : FB_HEIGHT - index * 20;
+  if (strips[index].height) {
+    fbStripBlit(backend->buffer(), strips[index], x, index * 20);
+  } else {
+    // Não cabe numa faixa: rasteriza só a parte visível neste quadro.
+    uint8_t rows[(FB_WIDTH + 7) / 8 * FB_HEIGHT];
+    if (rasterizer(rows, FB_WIDTH, h, x, ca_lineTxt[index], ui8_txtSize[index]))
+      fbBlitRows(backend->buffer(), rows, FB_WIDTH, h, 0, index * 20);
+  }
+  // Área ocupada: de 0 até o fim do texto (a parte antes de x já foi apagada por clearLine).
+  int16_t right = x + textWidth < 0 ? 0 : (x + textWidth > FB_WIDTH ? FB_WIDTH : x + textWidth);
+  ui8_drawnWidth[index] = right;
+  ui8_drawnHeight[index] = h;
+  dirty.mark(0, index * 20, right, ui8_drawnHeight[index]);
+}
+
+void FbScreen_c::cacheLine(uint8_t index) {
+  uint8_t size = ui8_txtSize[index];
+  uint16_t w = 6 * size * ui8_lineSize[index];
+  uint8_t h = 8 * size;
+  strips[index].width = 0;
+  strips[index].height = 0;
+  if (!size || w > FB_STRIP_WIDTH || h > FB_STRIP_HEIGHT) return; // rasterizada a cada quadro
+  uint8_t rows[(FB_STRIP_WIDTH + 7) / 8 * FB_STRIP_HEIGHT];
+  if (!rasterizer(rows, w ? w : 1, h, 0, ca_lineTxt[index], size)) return;
+  fbStripFromRows(strips[index], rows, w, h);
+}
+
+void FbScreen_c::scrollBy(uint8_t index, uint32_t px) {
+  if (px > 1024) px = 1024; // após uma parada longa a fase exata não importa
+  for (; px; px--) {
+    if (scrollLeft[index]) {
+      ++i16_lineWidth[index];
+    } else {
+      --i16_lineWidth[index];
+    }
+    if (i16_lineWidth[index] < i16_lineMinWidth[index]) {
+      scrollLeft[index] = true;
+    }
+    if (i16_lineWidth[index] > 12) {
+      scrollLeft[index] = false;
+    }
+  }
+}
+
+void FbScreen_c::setText(uint8_t line, const char txt[], uint8_t txtSize) {
+  if (line < 1 || line > 3) return;
+  if (txt != ca_lineTxt[line - 1]) { // begin() reenvia o próprio texto
+    strncpy(ca_lineTxt[line - 1], txt, sizeof(ca_lineTxt[0]) - 1);
+    ca_lineTxt[line - 1][sizeof(ca_lineTxt[0]) - 1] = '\0';
+  }
+  ui8_lineSize[line - 1] = strlen(ca_lineTxt[line - 1]);
+  i16_lineMinWidth[line - 1] = -12 * (ui8_lineSize[line - 1] - 9);
+  ui8_txtSize[line - 1] = txtSize;
+  cacheLine(line - 1);
+  ui8_changedLines |= 1 << (line - 1);
+  update();
+}
+
+void FbScreen_c::setScroll(uint16_t pxPerSec, uint8_t maxFps) {
+  ui16_scrollSpeed = pxPerSec;
+  ui32_frameUs = 1000000UL / (maxFps ? maxFps : 1);
+}
+
+void FbScreen_c::setTrend(FbTrend_c *chart) {
+  trend = chart;
+  if (trend) trend->invalidate(); // a região pode ter conteúdo antigo; mantém a escala escolhida
+}
+
+bool FbScreen_c::startRenderer(uint16_t fps, uint8_t core) {
+  if (!backend) return false;
+  update(); // o que estiver pendente vai pelo caminho direto antes da troca
+  return renderer.begin(backend->buffer(), [](void *ctx, uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) {
+    ((FbBackend_c *)ctx)->write(page0, page1, x0, x1, fb);
+  }, backend, fps, core);
+}
+
+void FbScreen_c::setBackend(FbBackend_c *target) {
+  renderer.end();
+  backend = target ? target : defaultBackend;
+}
+
+void FbScreen_c::setRasterizer(fbRasterizer_t raster) {
+  rasterizer = raster ? raster : fbTextRows;
+  for (uint8_t i = 0; i < 3; i++) cacheLine(i);
+  ui8_changedLines = 0x07;
+}
+
+displayStats_t FbScreen_c::stats() const {
+  if (!backend) return displayStats_t{ui32_frames, ui32_renderUs, ui32_maxRenderUs, 0, 0};
+  return displayStats_t{ui32_frames, ui32_renderUs, ui32_maxRenderUs, backend->bytes(), backend->windows()};
+}
+
+void FbScreen_c::resetStats(void) {
+  ui32_frames = 0;
+  ui32_renderUs = 0;
+  ui32_maxRenderUs = 0;
+  if (backend) backend->resetCounters();
+}
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef __FBTEXT_H
+#define __FBTEXT_H
+
+/**
+ * @file fbText.h
+ * @brief Faixas de texto pré-rasterizadas e cópia (blit) para framebuffer em páginas.
+ *
+ * Uma linha de texto é rasterizada uma única vez (quando muda) numa faixa de 1 bit por pixel
+ * guardada por colunas: cada coluna é uma palavra de 32 bits, bit r = linha r da faixa.
+ * Desenhar a linha num quadro é só copiar as colunas visíveis para o framebuffer do SSD1306
+ * (fb[x + página * FB_WIDTH], bit y & 7): cada coluna é deslocada de y & 7 numa palavra de
+ * 64 bits e espalhada pelas páginas que ela cobre, sem reprocessar os glifos.
+ *
+ * Nada aqui depende do Arduino; a conversão parte de um bitmap por linhas no formato do
+ * GFXcanvas1 (MSB primeiro, (largura + 7) / 8 bytes por linha). fbTextRows() gera esse
+ * bitmap com uma fonte 5x7 embutida (ASCII 0x20 a 0x7E), na mesma geometria da fonte padrão
+ * do Adafruit_GFX (células de 6 × 8 pixels multiplicadas pelo tamanho), para rasterizar
+ * texto sem o Adafruit_GFX (ex.: no host).
+ */
+
+#include "fbDirty.h"
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FB_STRIP_WIDTH
+/**
+ * @brief Largura máxima de uma faixa em pixels (19 caracteres de tamanho 2 = 228).
+ */
+#define FB_STRIP_WIDTH 256
+#endif
+
+#define FB_STRIP_HEIGHT 32 ///< Altura máxima de uma faixa (bits por coluna).
+
+/**
+ * @struct fbStrip_t
+ * @brief Linha de texto rasterizada, por colunas.
+ *
+ * @param cols Colunas da faixa (bit r = linha r).
+ * @param width Número de colunas válidas (0 = faixa vazia ou inválida).
+ * @param height Altura em pixels.
+ */
+struct fbStrip_t {
+  uint32_t cols[FB_STRIP_WIDTH];
+  uint16_t width;
+  uint8_t height;
+};
+
+/**
+ * @brief Fonte 5x7 (ASCII 0x20 a 0x7E): 5 colunas por caractere, bit r = linha r.
+ */
+const uint8_t fbFont5x7[95][5] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, // ' ' ! "
+  {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, // # $ %
+  {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00}, // & ' (
+  {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x14, 0x08, 0x3E, 0x08, 0x14}, {0x08, 0x08, 0x3E, 0x08, 0x08}, // ) * +
+  {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, // , - .
+  {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, // / 0 1
+  {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10}, // 2 3 4
+  {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03}, // 5 6 7
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00}, // 8 9 :
+  {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, // ; < =
+  {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E}, // > ? @
+  {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22}, // A B C
+  {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x01, 0x01}, // D E F
+  {0x3E, 0x41, 0x41, 0x51, 0x32}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, // G H I
+  {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40}, // J K L
+  {0x7F, 0x02, 0x04, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E}, // M N O
+  {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, // P Q R
+  {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, // S T U
+  {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x7F, 0x20, 0x18, 0x20, 0x7F}, {0x63, 0x14, 0x08, 0x14, 0x63}, // V W X
+  {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00}, // Y Z [
+  {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, // \ ] ^
+  {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, // _ ` a
+  {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F}, // b c d
+  {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E}, // e f g
+  {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00}, // h i j
+  {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, // k l m
+  {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08}, // n o p
+  {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20}, // q r s
+  {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, // t u v
+  {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, // w x y
+  {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00}, // z { |
+  {0x00, 0x41, 0x36, 0x08, 0x00}, {0x02, 0x01, 0x02, 0x04, 0x02}                                   // } ~
+};
+
+/**
+ * @brief Rasteriza texto com a fonte embutida num bitmap por linhas (formato GFXcanvas1).
+ *
+ * Cada caractere ocupa 6 * size colunas e 8 * size linhas, como no Adafruit_GFX; caracteres
+ * fora de 0x20 a 0x7E saem como '?'. O bitmap é zerado antes do desenho.
+ * @param rows Bitmap de destino: (w + 7) / 8 bytes por linha, h linhas.
+ * @param w Largura do bitmap.
+ * @param h Altura do bitmap.
+ * @param x Coluna do bitmap onde começa o texto (pode ser negativa).
+ * @param text Texto terminado em '\0'.
+ * @param size Fator de escala da fonte (1 = 6 × 8 pixels por caractere).
+ * @return true (a assinatura segue fbRasterizer_t, em fbScreen.h).
+ */
+inline bool fbTextRows(uint8_t *rows, uint16_t w, uint8_t h, int16_t x, const char *text, uint8_t size) {
+  uint16_t stride = (w + 7) / 8;
+  memset(rows, 0, (size_t)stride * h);
+  for (; *text && x < (int16_t)w; text++, x += 6 * size) {
+    if (x + 6 * size <= 0) continue;
+    uint8_t c = (uint8_t)*text;
+    const uint8_t *glyph = fbFont5x7[(c >= 0x20 && c <= 0x7E ? c : '?') - 0x20];
+    for (uint8_t col = 0; col < 5; col++) {
+      for (uint8_t r = 0; r < 8; r++) {
+        if (!((glyph[col] >> r) & 1)) continue;
+        for (uint8_t dy = 0; dy < size; dy++) {
+          uint16_t y = r * size + dy;
+          if (y >= h) break;
+          uint8_t *row = rows + y * stride;
+          for (uint8_t dx = 0; dx < size; dx++) {
+            int16_t px = x + col * size + dx;
+            if (px >= 0 && px < (int16_t)w) row[px >> 3] |= 0x80 >> (px & 7);
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Preenche uma faixa a partir de um bitmap por linhas (formato GFXcanvas1).
+ * @param strip Faixa de destino.
+ * @param rows Bitmap: (w + 7) / 8 bytes por linha, MSB = pixel mais à esquerda.
+ * @param w Largura do bitmap.
+ * @param h Altura do bitmap.
+ * @return false se o bitmap não couber numa faixa (a faixa fica vazia).
+ */
+inline bool fbStripFromRows(fbStrip_t &strip, const uint8_t *rows, uint16_t w, uint8_t h) {
+  strip.width = 0;
+  strip.height = 0;
+  if (w > FB_STRIP_WIDTH || h > FB_STRIP_HEIGHT) return false;
+  uint16_t stride = (w + 7) / 8;
+  for (uint16_t x = 0; x < w; x++) strip.cols[x] = 0;
+  for (uint8_t y = 0; y < h; y++) {
+    const uint8_t *row = rows + y * stride;
+    for (uint16_t x = 0; x < w; x++)
+      if (row[x >> 3] & (0x80 >> (x & 7))) strip.cols[x] |= 1UL << y;
+  }
+  strip.width = w;
+  strip.height = h;
+  return true;
+}
+
+/**
+ * @brief Copia (OU) a parte visível de uma faixa para o framebuffer, com a origem em (x, y).
+ * @param fb Framebuffer em páginas (FB_WIDTH * FB_PAGES bytes).
+ * @param strip Faixa a copiar.
+ * @param x Coluna do framebuffer onde fica a coluna 0 da faixa (pode ser negativa).
+ * @param y Linha do framebuffer onde fica a linha 0 da faixa (0 a FB_HEIGHT - 1).
+ */
+inline void fbStripBlit(uint8_t *fb, const fbStrip_t &strip, int16_t x, int16_t y) {
+  if (y < 0 || y >= FB_HEIGHT) return;
+  int16_t from = x < 0 ? 0 : x;
+  int16_t to = x + (int16_t)strip.width;
+  if (to > FB_WIDTH) to = FB_WIDTH;
+  uint8_t page0 = y >> 3, shift = y & 7;
+  for (int16_t dx = from; dx < to; dx++) {
+    uint64_t col = (uint64_t)strip.cols[dx - x] << shift;
+    for (uint8_t p = page0; col && p < FB_PAGES; p++, col >>= 8) fb[p * FB_WIDTH + dx] |= (uint8_t)col;
+  }
+}
+
+/**
+ * @brief Copia (OU) um bitmap por linhas (formato GFXcanvas1) para o framebuffer em (x, y).
+ *
+ * Caminho pixel a pixel, para o que não cabe numa faixa.
+ */
+inline void fbBlitRows(uint8_t *fb, const uint8_t *rows, uint16_t w, uint8_t h, int16_t x, int16_t y) {
+  uint16_t stride = (w + 7) / 8;
+  for (uint8_t r = 0; r < h; r++) {
+    int16_t dy = y + r;
+    if (dy < 0 || dy >= FB_HEIGHT) continue;
+    const uint8_t *row = rows + r * stride;
+    uint8_t *dst = fb + (dy >> 3) * FB_WIDTH;
+    uint8_t bit = 1 << (dy & 7);
+    for (uint16_t c = 0; c < w; c++) {
+      int16_t dx = x + c;
+      if (dx >= 0 && dx < FB_WIDTH && (row[c >> 3] & (0x80 >> (c & 7)))) dst[dx] |= bit;
+    }
+  }
+}
+
+/**
+ * @brief Apaga um retângulo do framebuffer (recortado à tela).
+ */
+inline void fbClearRect(uint8_t *fb, int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > FB_WIDTH) w = FB_WIDTH - x;
+  if (y + h > FB_HEIGHT) h = FB_HEIGHT - y;
+  if (w <= 0 || h <= 0) return;
+  for (uint8_t p = y >> 3; p <= (y + h - 1) >> 3; p++) {
+    // Bits desta página dentro de [y, y + h).
+    int16_t top = p * 8 > y ? p * 8 : y;
+    int16_t bottom = p * 8 + 8 < y + h ? p * 8 + 8 : y + h;
+    uint8_t mask = (uint8_t)(((1u << (bottom - top)) - 1) << (top - p * 8));
+    uint8_t *row = fb + p * FB_WIDTH + x;
+    for (int16_t i = 0; i < w; i++) row[i] &= ~mask;
+  }
+}
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef __FBTREND_H
+#define __FBTREND_H
+
+/**
+ * @file fbTrend.h
+ * @brief Gráfico de tendência (sparkline) incremental para framebuffer em páginas.
+ *
+ * Cada coluna do gráfico guarda o mínimo e o máximo de samplesPerColumn amostras num anel
+ * com uma entrada por coluna. Quando colunas novas se completam, draw() desloca a região do
+ * framebuffer para a esquerda e desenha só as colunas novas, então o custo por amostra é
+ * constante, não proporcional à largura do gráfico.
+ *
+ * A escala automática também é incremental: o intervalo dos dados só é recalculado sobre o
+ * anel quando a coluna que sai dele continha o mínimo ou o máximo. A escala exibida tem folga
+ * (1/8 do intervalo de cada lado) e só muda quando os dados saem dela ou passam a ocupar
+ * menos da metade; só então o gráfico inteiro é redesenhado (contado em redraws()).
+ *
+ * Nada aqui depende do Arduino; o framebuffer segue o layout do SSD1306 (fb[x + página *
+ * FB_WIDTH], bit y & 7) e a região pode começar em qualquer linha. push() e draw() devem ser
+ * chamadas na mesma thread.
+ *
+ * Uso (com Display_c):
+ *   FbTrend_c trend(0, 24, 128, 40, 4);   // 4 amostras por coluna
+ *   IIKit.disp.setTrend(&trend);
+ *   loop() { trend.push(IIKit.ads.analogRead(0)); }
+ */
+
+#include "fbDirty.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @class FbTrend_c
+ * @brief Gráfico de tendência com anel de mínimo/máximo por coluna.
+ */
+class FbTrend_c {
+public:
+  /**
+   * @brief Construtor.
+   * @param x Coluna esquerda da região.
+   * @param y Linha superior da região.
+   * @param w Largura em colunas (uma coluna por entrada do anel).
+   * @param h Altura em pixels.
+   * @param samplesPerColumn Amostras agregadas em cada coluna.
+   */
+  FbTrend_c(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t samplesPerColumn = 1)
+      : _x(x), _y(y), _samplesPerColumn(samplesPerColumn ? samplesPerColumn : 1) {
+    if (_x >= FB_WIDTH) _x = FB_WIDTH - 1;
+    if (_y >= FB_HEIGHT) _y = FB_HEIGHT - 1;
+    _w = (w && _x + w <= FB_WIDTH) ? w : FB_WIDTH - _x;
+    _h = (h && _y + h <= FB_HEIGHT) ? h : FB_HEIGHT - _y;
+  }
+
+  /**
+   * @brief Acrescenta uma amostra.
+   */
+  void push(int32_t v) {
+    if (_n == 0) {
+      _colMin = _colMax = v;
+      if (_hasLast) include(_last); // liga a coluna à anterior
+    }
+    include(v);
+    _last = v;
+    _hasLast = true;
+    if (++_n >= _samplesPerColumn) {
+      commit(_colMin, _colMax);
+      _n = 0;
+    }
+  }
+
+  /**
+   * @brief Acrescenta um bloco de amostras (ex.: de AdcDmaEsp::read()).
+   */
+  template <typename T>
+  void pushN(const T *values, size_t count) {
+    for (size_t i = 0; i < count; i++) push((int32_t)values[i]);
+  }
+
+  /**
+   * @brief Usa uma escala fixa (valores fora dela são recortados).
+   */
+  void setRange(int32_t lo, int32_t hi) {
+    _auto = false;
+    _lo = lo;
+    _hi = hi > lo ? hi : lo + 1;
+    _redraw = true;
+  }
+
+  /**
+   * @brief Volta à escala automática.
+   */
+  void setAutoRange() {
+    _auto = true;
+    rescan();
+    fit(true);
+    _redraw = true;
+  }
+
+  /**
+   * @brief Faz o próximo draw() redesenhar a região inteira, sem mexer na escala.
+   *
+   * Para quando o framebuffer foi alterado por fora (ex.: o gráfico acabou de ser ligado a
+   * um display).
+   */
+  void invalidate() { _redraw = true; }
+
+  /**
+   * @brief Apaga o histórico.
+   */
+  void clear() {
+    _count = 0;
+    _head = 0;
+    _n = 0;
+    _hasLast = false;
+    _redraw = true;
+  }
+
+  /**
+   * @brief Indica se há algo a desenhar.
+   */
+  bool pending() const { return _redraw || _newCols; }
+
+  /**
+   * @brief Aplica ao framebuffer as colunas novas (ou redesenha tudo se a escala mudou).
+   * @param fb Framebuffer em páginas.
+   * @param dirty Regiões alteradas, onde a região do gráfico é marcada.
+   */
+  void draw(uint8_t *fb, fbDirty_t &dirty) {
+    if (!pending()) return;
+    if (_redraw || _newCols >= _w) {
+      clearColumns(fb, _x, _w);
+      for (uint8_t i = 0; i < _count; i++) drawColumn(fb, _x + _w - _count + i, i);
+      _redraws++;
+    } else {
+      shiftLeft(fb, _newCols);
+      clearColumns(fb, _x + _w - _newCols, _newCols);
+      for (uint8_t i = _count - _newCols; i < _count; i++) drawColumn(fb, _x + _w - _count + i, i);
+    }
+    _redraw = false;
+    _newCols = 0;
+    dirty.mark(_x, _y, _w, _h);
+  }
+
+  /**
+   * @brief Limite inferior da escala atual.
+   */
+  int32_t lo() const { return _lo; }
+
+  /**
+   * @brief Limite superior da escala atual.
+   */
+  int32_t hi() const { return _hi; }
+
+  /**
+   * @brief Número de vezes que o gráfico foi redesenhado por inteiro.
+   */
+  uint32_t redraws() const { return _redraws; }
+
+private:
+  void include(int32_t v) {
+    if (v < _colMin) _colMin = v;
+    if (v > _colMax) _colMax = v;
+  }
+
+  /**
+   * @brief Coluna i do anel (0 = mais antiga).
+   */
+  uint8_t slot(uint8_t i) const { return (uint8_t)((_head + _w - _count + i) % _w); }
+
+  /**
+   * @brief Fecha uma coluna: grava no anel e atualiza a escala.
+   */
+  void commit(int32_t mn, int32_t mx) {
+    bool evicted = _count == _w;
+    int32_t oldMin = _min[_head], oldMax = _max[_head];
+    _min[_head] = mn;
+    _max[_head] = mx;
+    _head = (_head + 1) % _w;
+    if (!evicted) _count++;
+    if (_newCols < _w) _newCols++;
+    if (!_auto) return;
+    if (_count == 1) {
+      _dataLo = mn;
+      _dataHi = mx;
+    } else if (evicted && (oldMin <= _dataLo || oldMax >= _dataHi)) {
+      rescan(); // a coluna que saiu tinha um extremo
+    } else {
+      if (mn < _dataLo) _dataLo = mn;
+      if (mx > _dataHi) _dataHi = mx;
+    }
+    fit(_count == 1);
+  }
+
+  /**
+   * @brief Recalcula o intervalo dos dados sobre o anel.
+   */
+  void rescan() {
+    if (!_count) return;
+    _dataLo = _min[slot(0)];
+    _dataHi = _max[slot(0)];
+    for (uint8_t i = 1; i < _count; i++) {
+      uint8_t s = slot(i);
+      if (_min[s] < _dataLo) _dataLo = _min[s];
+      if (_max[s] > _dataHi) _dataHi = _max[s];
+    }
+  }
+
+  /**
+   * @brief Ajusta a escala exibida se os dados saíram dela ou ocupam menos da metade.
+   */
+  void fit(bool force) {
+    if (!_count) return;
+    int64_t span = (int64_t)_dataHi - _dataLo;
+    int64_t margin = span / 8 ? span / 8 : 1;
+    bool outside = _dataLo < _lo || _dataHi > _hi;
+    // Com sinal quase constante a escala nova não seria menor que a atual: não redesenha.
+    bool small = 2 * span < (int64_t)_hi - _lo && span + 2 * margin < (int64_t)_hi - _lo;
+    if (!force && !outside && !small) return;
+    _lo = (int32_t)((int64_t)_dataLo - margin);
+    _hi = (int32_t)((int64_t)_dataHi + margin);
+    _redraw = true;
+  }
+
+  /**
+   * @brief Linha do framebuffer correspondente a um valor (recortada à região).
+   */
+  uint8_t rowOf(int32_t v) const {
+    int64_t span = (int64_t)_hi - _lo;
+    if (span <= 0) return _y + _h / 2;
+    int64_t r = ((int64_t)v - _lo) * (_h - 1) / span;
+    if (r < 0) r = 0;
+    if (r > _h - 1) r = _h - 1;
+    return _y + _h - 1 - (uint8_t)r;
+  }
+
+  /**
+   * @brief Máscara dos bits da página p que pertencem às linhas [y0, y1] (inclusivas).
+   */
+  static uint8_t pageMask(uint8_t p, uint8_t y0, uint8_t y1) {
+    int16_t top = p * 8 > y0 ? p * 8 : y0;
+    int16_t bottom = p * 8 + 7 < y1 ? p * 8 + 7 : y1;
+    if (top > bottom) return 0;
+    return (uint8_t)(((1u << (bottom - top + 1)) - 1) << (top - p * 8));
+  }
+
+  void drawColumn(uint8_t *fb, uint8_t cx, uint8_t i) const {
+    uint8_t s = slot(i);
+    uint8_t top = rowOf(_max[s]), bottom = rowOf(_min[s]);
+    for (uint8_t p = top >> 3; p <= bottom >> 3; p++) fb[p * FB_WIDTH + cx] |= pageMask(p, top, bottom);
+  }
+
+  void clearColumns(uint8_t *fb, uint8_t from, uint8_t n) const {
+    uint8_t y1 = _y + _h - 1;
+    for (uint8_t p = _y >> 3; p <= y1 >> 3; p++) {
+      uint8_t keep = ~pageMask(p, _y, y1);
+      for (uint8_t c = 0; c < n; c++) fb[p * FB_WIDTH + from + c] &= keep;
+    }
+  }
+
+  /**
+   * @brief Desloca a região k colunas para a esquerda (só os bits da região).
+   */
+  void shiftLeft(uint8_t *fb, uint8_t k) const {
+    uint8_t y1 = _y + _h - 1;
+    for (uint8_t p = _y >> 3; p <= y1 >> 3; p++) {
+      uint8_t mask = pageMask(p, _y, y1);
+      uint8_t *row = fb + p * FB_WIDTH + _x;
+      if (mask == 0xFF) {
+        memmove(row, row + k, _w - k);
+      } else {
+        for (uint8_t c = 0; c + k < _w; c++) row[c] = (row[c] & ~mask) | (row[c + k] & mask);
+      }
+    }
+  }
+
+  int32_t _min[FB_WIDTH];
+  int32_t _max[FB_WIDTH];
+  uint8_t _x, _y, _w, _h;
+  uint16_t _samplesPerColumn;
+  uint16_t _n = 0;       ///< Amostras na coluna em formação.
+  int32_t _colMin = 0;   ///< Mínimo da coluna em formação.
+  int32_t _colMax = 0;   ///< Máximo da coluna em formação.
+  int32_t _last = 0;     ///< Última amostra (liga colunas vizinhas).
+  bool _hasLast = false;
+  uint8_t _head = 0;     ///< Próxima posição do anel.
+  uint8_t _count = 0;    ///< Colunas no anel.
+  uint8_t _newCols = 0;  ///< Colunas fechadas e ainda não desenhadas.
+  bool _redraw = true;   ///< Escala ou região mudou: redesenhar tudo.
+  bool _auto = true;
+  int32_t _lo = 0;       ///< Escala exibida.
+  int32_t _hi = 1;
+  int32_t _dataLo = 0;   ///< Intervalo dos dados no anel.
+  int32_t _dataHi = 0;
+  uint32_t _redraws = 0;
+};
+
+#endif
@@ -0,0 +1,319 @@
+#ifndef __JCORO_H
+#define __JCORO_H
+
+/**
+ * @file jcoro.h
+ * @brief Tarefas em forma de corrotina (C++20) executadas pelo escalonador do jtask.
+ *
+ * Uma sequência com esperas (iniciar conversão, esperar, ler, esperar, enviar) pode ser
+ * escrita de forma linear, sem máquina de estados e sem delay():
+ *
+ *   jcoro_t medir() {
+ *     for (;;) {
+ *       ads.startConversion();
+ *       co_await jcoroSleep(1200);              // libera o loop por 1,2 ms
+ *       wserial::plot("v", ads.read());
+ *       co_await jcoroNextPeriod();             // próxima liberação do período (fase fixa)
+ *     }
+ *   }
+ *   jcoroStart(medir(), 10000);
+ *
+ * Cada corrotina ocupa uma entrada do jtask; ao suspender, o awaitable reagenda a entrada
+ * (jtaskReschedule) para o instante em que ela deve continuar, e jtaskLoop() a retoma como
+ * qualquer outra tarefa. Esperas por condição (fila, ADC) são verificadas a cada pollUs
+ * sem retomar a corrotina. Os quadros das corrotinas vêm de uma arena estática de
+ * JCORO_FRAMES blocos de JCORO_FRAME_SIZE bytes; se não houver bloco livre, a corrotina
+ * simplesmente não é criada (jcoroStart() retorna JTASK_INVALID).
+ *
+ * As corrotinas rodam no próprio jtaskLoop(); não use com o modo executor (jtaskPool.h).
+ * Requer C++20 (-std=gnu++20).
+ */
+
+#if !defined(__cpp_impl_coroutine)
+#error "jcoro.h requer C++20 com corrotinas (-std=gnu++20)"
+#endif
+
+#include "jtask.h"
+#include "jqueue.h"
+#include <coroutine>
+
+#ifndef JCORO_FRAMES
+  /**
+   * @brief Número de quadros de corrotina na arena (até 32).
+   */
+  #define JCORO_FRAMES 4
+#endif
+
+#ifndef JCORO_FRAME_SIZE
+  /**
+   * @brief Tamanho de cada quadro (bytes): estado da corrotina, variáveis locais e awaitables.
+   */
+  #define JCORO_FRAME_SIZE 256
+#endif
+
+#ifndef JCORO_POLL_US
+  /**
+   * @brief Intervalo padrão (µs) entre verificações das esperas por condição.
+   */
+  #define JCORO_POLL_US 1000
+#endif
+
+static_assert(JCORO_FRAMES <= 32, "JCORO_FRAMES deve ser no maximo 32");
+
+/**
+ * @brief Arena dos quadros das corrotinas.
+ */
+alignas(16) unsigned char jcoroArena[JCORO_FRAMES][JCORO_FRAME_SIZE];
+
+/**
+ * @brief Máscara dos blocos em uso.
+ */
+uint32_t jcoroArenaUsed = 0;
+
+/**
+ * @brief Número de corrotinas que não puderam ser criadas (arena cheia ou quadro grande demais).
+ */
+uint32_t jcoroArenaFailures = 0;
+
+/**
+ * @brief Reserva um bloco da arena.
+ * @param size Tamanho pedido pelo compilador para o quadro.
+ * @return Ponteiro para o bloco, ou nullptr se não couber ou não houver bloco livre.
+ */
+void *jcoroArenaAlloc(size_t size) {
+  if (size <= JCORO_FRAME_SIZE) {
+    for (uint8_t i = 0; i < JCORO_FRAMES; i++) {
+      if (jcoroArenaUsed & (1UL << i)) continue;
+      jcoroArenaUsed |= 1UL << i;
+      return jcoroArena[i];
+    }
+  }
+  jcoroArenaFailures++;
+  return nullptr;
+}
+
+/**
+ * @brief Devolve um bloco à arena.
+ */
+void jcoroArenaFree(void *p) {
+  size_t i = ((unsigned char *)p - &jcoroArena[0][0]) / JCORO_FRAME_SIZE;
+  if (i < JCORO_FRAMES) jcoroArenaUsed &= ~(1UL << i);
+}
+
+/**
+ * @brief Número de blocos livres na arena.
+ */
+uint8_t jcoroArenaAvailable() {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < JCORO_FRAMES; i++)
+    if (!(jcoroArenaUsed & (1UL << i))) n++;
+  return n;
+}
+
+/**
+ * @class jcoro_t
+ * @brief Tipo de retorno de uma corrotina do jtask.
+ *
+ * A corrotina começa suspensa; jcoroStart() a entrega ao escalonador. Se o objeto for
+ * destruído sem ter sido iniciado, o quadro é liberado.
+ */
+class jcoro_t {
+public:
+  struct promise_type {
+    int id = JTASK_INVALID;                ///< Entrada do jtask que retoma a corrotina.
+    unsigned long period = 0;              ///< Período usado por jcoroNextPeriod().
+    unsigned long phase = 0;               ///< Última liberação periódica.
+    bool (*ready)(void *ctx) = nullptr;    ///< Condição de espera (nullptr = retomar direto).
+    void *readyCtx = nullptr;
+    unsigned long pollUs = JCORO_POLL_US;
+
+    static void *operator new(size_t size) noexcept { return jcoroArenaAlloc(size); }
+    static void operator delete(void *p) noexcept { jcoroArenaFree(p); }
+    static jcoro_t get_return_object_on_allocation_failure() noexcept { return jcoro_t(); }
+
+    jcoro_t get_return_object() noexcept {
+      return jcoro_t(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { abort(); }
+  };
+
+  typedef std::coroutine_handle<promise_type> handle_t;
+
+  jcoro_t() = default;
+  explicit jcoro_t(handle_t h) : _h(h) {}
+  jcoro_t(jcoro_t &&o) noexcept : _h(o._h) { o._h = nullptr; }
+  jcoro_t &operator=(jcoro_t &&o) noexcept {
+    if (this != &o) {
+      if (_h) _h.destroy();
+      _h = o._h;
+      o._h = nullptr;
+    }
+    return *this;
+  }
+  jcoro_t(const jcoro_t &) = delete;
+  jcoro_t &operator=(const jcoro_t &) = delete;
+  ~jcoro_t() {
+    if (_h) _h.destroy();
+  }
+
+  /**
+   * @brief Indica se o quadro foi criado (falso se a arena estava cheia).
+   */
+  bool valid() const { return (bool)_h; }
+
+  /**
+   * @brief Entrega o quadro a quem vai executá-lo (uso interno de jcoroStart()).
+   */
+  handle_t release() {
+    handle_t h = _h;
+    _h = nullptr;
+    return h;
+  }
+
+private:
+  handle_t _h = nullptr;
+};
+
+/**
+ * @brief Função registrada no jtask para cada corrotina: verifica a espera e retoma.
+ */
+void jcoroStep(void *ctx) {
+  jcoro_t::handle_t h = jcoro_t::handle_t::from_address(ctx);
+  jcoro_t::promise_type &p = h.promise();
+  if (p.ready) {
+    if (!p.ready(p.readyCtx)) {
+      jtaskReschedule(p.id, jtaskNow() + p.pollUs);
+      return;
+    }
+    p.ready = nullptr;
+  }
+  h.resume();
+  if (h.done()) {
+    jtaskDetach(p.id);
+    h.destroy();
+  }
+}
+
+/**
+ * @brief Registra uma corrotina no escalonador; ela começa a rodar na próxima passagem.
+ *
+ * @param coro Corrotina recém-criada (o objeto fica vazio).
+ * @param period Período usado por jcoroNextPeriod() e pela prioridade rate-monotonic.
+ * @return Identificador da entrada no jtask, ou JTASK_INVALID se a arena ou o pool estiverem cheios.
+ */
+int jcoroStart(jcoro_t &&coro, unsigned long period = 0) {
+  if (!coro.valid()) return JTASK_INVALID;
+  jcoro_t::handle_t h = coro.release();
+  int id = jtaskAttach(jcoroStep, h.address(), period);
+  if (id == JTASK_INVALID) {
+    h.destroy();
+    return JTASK_INVALID;
+  }
+  unsigned long now = jtaskNow();
+  h.promise().id = id;
+  h.promise().period = period;
+  h.promise().phase = now;
+  jtaskReschedule(id, now);
+  return id;
+}
+
+/**
+ * @brief Interrompe uma corrotina, liberando seu quadro e sua entrada no jtask.
+ *
+ * Não deve ser chamada de dentro da própria corrotina (basta retornar com co_return).
+ * @param id Identificador retornado por jcoroStart().
+ * @return false se o identificador não corresponder a uma corrotina ativa.
+ */
+bool jcoroStop(int id) {
+  if (id < 0 || id >= jtaskCapacity || !jtaskStruct[id].active || jtaskStruct[id].fn != jcoroStep) return false;
+  void *frame = jtaskStruct[id].ctx;
+  jtaskDetach(id);
+  jcoro_t::handle_t::from_address(frame).destroy();
+  return true;
+}
+
+/**
+ * @brief Awaitable: suspende por us microssegundos.
+ */
+struct jcoroSleep {
+  unsigned long us;
+  explicit jcoroSleep(unsigned long us) : us(us) {}
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(jcoro_t::handle_t h) noexcept { jtaskReschedule(h.promise().id, jtaskNow() + us); }
+  void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Awaitable: suspende até a próxima liberação do período, com fase fixa.
+ *
+ * Liberações já vencidas são puladas. Com período 0 equivale a ceder até a próxima passagem.
+ */
+struct jcoroNextPeriod {
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(jcoro_t::handle_t h) noexcept {
+    jcoro_t::promise_type &p = h.promise();
+    unsigned long now = jtaskNow();
+    if (p.period == 0) {
+      p.phase = now;
+    } else {
+      p.phase += p.period;
+      if (jtaskBefore(p.phase, now)) p.phase += ((now - p.phase) / p.period + 1) * p.period;
+    }
+    jtaskReschedule(p.id, p.phase);
+  }
+  void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Base das esperas por condição: instala a verificação e agenda a primeira checagem.
+ */
+template <typename Self>
+struct jcoroCondition {
+  unsigned long pollUs;
+  void await_suspend(jcoro_t::handle_t h) noexcept {
+    jcoro_t::promise_type &p = h.promise();
+    p.ready = [](void *ctx) { return ((Self *)ctx)->await_ready(); };
+    p.readyCtx = static_cast<Self *>(this);
+    p.pollUs = pollUs;
+    jtaskReschedule(p.id, jtaskNow() + pollUs);
+  }
+};
+
+/**
+ * @brief Awaitable: espera um item de uma jQueue_t; co_await retorna o item.
+ */
+struct jcoroReceive : jcoroCondition<jcoroReceive> {
+  jQueue_t *queue;
+  void *item = nullptr;
+  explicit jcoroReceive(jQueue_t *queue, unsigned long pollUs = JCORO_POLL_US) : queue(queue) {
+    this->pollUs = pollUs;
+  }
+  bool await_ready() noexcept { return jQueueReceive(queue, &item); }
+  void *await_resume() const noexcept { return item; }
+};
+
+/**
+ * @brief Awaitable: espera uma fonte de amostras (ex.: AdcDmaEsp) ter ao menos min amostras.
+ *
+ * Aceita qualquer objeto com available(). co_await retorna o número de amostras disponíveis.
+ */
+template <typename Source>
+struct jcoroAvailable : jcoroCondition<jcoroAvailable<Source>> {
+  Source &source;
+  size_t min;
+  size_t count = 0;
+  jcoroAvailable(Source &source, size_t min = 1, unsigned long pollUs = JCORO_POLL_US)
+    : source(source), min(min) {
+    this->pollUs = pollUs;
+  }
+  bool await_ready() noexcept {
+    count = source.available();
+    return count >= min;
+  }
+  size_t await_resume() const noexcept { return count; }
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef __JPOOL_H
+#define __JPOOL_H
+
+/**
+ * @file jpool.h
+ * @brief Pool de blocos de tamanho fixo, sem trava, para passar mensagens sem cópia e sem heap.
+ *
+ * Um produtor (ISR ou task) pega um bloco com alloc(), preenche e envia o ponteiro (ou o
+ * índice, com indexOf()) por uma JQueue; o consumidor processa e devolve com free(). Tanto
+ * alloc() quanto free() podem ser chamadas de qualquer ISR ou task, nos dois núcleos.
+ *
+ * A lista de blocos livres é uma pilha cujo topo fica numa única palavra de 32 bits:
+ * 16 bits de índice e 16 bits de etiqueta, incrementada a cada troca. Assim um
+ * compare-and-swap nunca é enganado por um topo que saiu e voltou (problema ABA).
+ *
+ * Uso:
+ *   JPool<64, 8> frames;                 // 8 blocos de 64 bytes
+ *   JQueue<void *, 8> fila;
+ *   // ISR:   void *b = frames.alloc(); if (b) { preenche(b); fila.sendFromISR(b); }
+ *   // task:  void *b; while (fila.receive(b)) { trata(b); frames.free(b); }
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+#include <atomic>
+
+/**
+ * @class JPool
+ * @brief Pool de N blocos de S bytes (alinhados a 8).
+ */
+template <size_t S, uint16_t N>
+class JPool {
+    static_assert(N > 0 && N < 0xFFFF, "JPool aceita de 1 a 65534 blocos");
+
+public:
+    /**
+     * @brief Distância entre blocos consecutivos (S arredondado para múltiplo de 8).
+     */
+    static constexpr size_t STRIDE = (S + 7) & ~(size_t)7;
+
+    JPool() : _top(0), _inUse(0), _highWater(0), _exhaustions(0) {
+        for (uint16_t i = 0; i < N; i++)
+            _next[i].store((i + 1 < N) ? i + 1 : NIL, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retira um bloco livre.
+     * @return Ponteiro para o bloco, ou nullptr se o pool estiver esgotado (contado em exhaustions()).
+     */
+    void *alloc() {
+        uint32_t top = _top.load(std::memory_order_acquire);
+        uint16_t index;
+        for (;;) {
+            index = top & 0xFFFF;
+            if (index == NIL) {
+                _exhaustions.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            uint32_t next = ((top >> 16) + 1) << 16 | _next[index].load(std::memory_order_relaxed);
+            if (_top.compare_exchange_weak(top, next, std::memory_order_acq_rel, std::memory_order_acquire)) break;
+        }
+        uint16_t used = _inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint16_t high = _highWater.load(std::memory_order_relaxed);
+        while (used > high && !_highWater.compare_exchange_weak(high, used, std::memory_order_relaxed)) {}
+        return _blocks + (size_t)index * STRIDE;
+    }
+
+    /**
+     * @brief Devolve um bloco obtido com alloc().
+     * @return false se o ponteiro não pertencer ao pool.
+     */
+    bool free(void *block) {
+        uint16_t index = indexOf(block);
+        if (index == NIL) return false;
+        uint32_t top = _top.load(std::memory_order_relaxed);
+        for (;;) {
+            _next[index].store(top & 0xFFFF, std::memory_order_relaxed);
+            uint32_t head = ((top >> 16) + 1) << 16 | index;
+            if (_top.compare_exchange_weak(top, head, std::memory_order_release, std::memory_order_relaxed)) break;
+        }
+        _inUse.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Índice de um bloco (para enviar 16 bits pela fila em vez do ponteiro).
+     * @return Índice, ou NIL se o ponteiro não for o início de um bloco do pool.
+     */
+    uint16_t indexOf(const void *block) const {
+        const unsigned char *p = (const unsigned char *)block;
+        if (p < _blocks || p >= _blocks + N * STRIDE) return NIL;
+        size_t offset = p - _blocks;
+        return (offset % STRIDE) ? NIL : (uint16_t)(offset / STRIDE);
+    }
+
+    /**
+     * @brief Bloco correspondente a um índice obtido com indexOf().
+     */
+    void *at(uint16_t index) { return (index < N) ? _blocks + (size_t)index * STRIDE : nullptr; }
+
+    /**
+     * @brief Número de blocos em uso agora.
+     */
+    uint16_t inUse() const { return _inUse.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Maior número de blocos em uso ao mesmo tempo desde o início.
+     */
+    uint16_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Número de chamadas a alloc() que encontraram o pool vazio.
+     */
+    uint32_t exhaustions() const { return _exhaustions.load(std::memory_order_relaxed); }
+
+    static constexpr uint16_t capacity() { return N; }
+    static constexpr size_t blockSize() { return S; }
+
+    /**
+     * @brief Índice inválido (também marca o fim da lista de livres).
+     */
+    static constexpr uint16_t NIL = 0xFFFF;
+
+private:
+    alignas(8) unsigned char _blocks[N * STRIDE];
+    std::atomic<uint16_t> _next[N];     ///< Próximo bloco livre (válido enquanto o bloco está livre).
+    std::atomic<uint32_t> _top;         ///< Etiqueta (16 bits altos) | índice do topo (16 bits baixos).
+    std::atomic<uint16_t> _inUse;
+    std::atomic<uint16_t> _highWater;
+    std::atomic<uint32_t> _exhaustions;
+};
+
+#endif
@@ -7,28 +7,365 @@
  *
  * Este arquivo implementa uma estrutura de fila genérica com suporte a diferentes tipos de dados,
  * permitindo o uso em ambientes com interrupções, como ISRs (Interrupt Service Routines).
+ *
+ * JQueue<T, N> é uma fila circular sem trava para um produtor e um consumidor (SPSC): os
+ * itens são copiados para dentro da fila, a capacidade N é uma potência de 2 e os índices
+ * de leitura e escrita são atômicos e crescem livremente (não há contador compartilhado).
+ * O produtor só escreve tail e o consumidor só escreve head, então a fila é correta mesmo
+ * com produtor e consumidor em núcleos diferentes do ESP32, ou numa ISR e numa task.
+ *
+ * sendN()/receiveN() movem vários itens publicando o índice uma única vez, e receiveWait()
+ * bloqueia o consumidor até chegar um item ou esgotar o tempo: no ESP32 por notificação de
+ * task (o produtor, mesmo numa ISR, só notifica se houver alguém esperando); no host por
+ * std::condition_variable.
+ *
+ * A notificação usa o índice JQUEUE_NOTIFY_INDEX do vetor de notificações da task
+ * consumidora. Com CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES >= 2 o padrão é o índice
+ * 1, separado do índice 0 usado por xTaskNotify()/ulTaskNotifyTake(). Com uma única entrada
+ * (padrão do ESP-IDF) a fila usa o índice 0: enquanto espera em receiveWait(), ela consome
+ * as notificações da task, então a consumidora não deve usar notificações para outra coisa.
+ *
+ * JQueueMPSC<T, N> aceita vários produtores (ISRs e tasks, em qualquer núcleo) e um único
+ * consumidor, sem travas: cada posição tem um número de sequência (fila limitada de Vyukov)
+ * e os produtores disputam apenas o índice de escrita com compare-and-swap. Com a fila cheia
+ * o envio falha na hora e é contado em drops().
+ *
+ * A API antiga (jQueue_t, jQueueSendFromISR, jQueueReceive...) é mantida sobre JQueue<void *, N>.
  */
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
 #include <stdlib.h>
+#include <atomic>
+#include <new>
+#ifndef ARDUINO
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#endif
+
+#ifdef ARDUINO
+#ifndef JQUEUE_NOTIFY_INDEX
+#if defined(configTASK_NOTIFICATION_ARRAY_ENTRIES) && configTASK_NOTIFICATION_ARRAY_ENTRIES > 1
+/**
+ * @brief Índice da notificação de task usado por receiveWait() (ver o topo do arquivo).
+ */
+#define JQUEUE_NOTIFY_INDEX 1
+#else
+#define JQUEUE_NOTIFY_INDEX 0
+#endif
+#endif
+#if defined(configTASK_NOTIFICATION_ARRAY_ENTRIES)
+static_assert(JQUEUE_NOTIFY_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES, "JQUEUE_NOTIFY_INDEX fora do vetor de notificacoes");
+#endif
+#endif
 
 #ifndef MAXLENGTHJQUEUE
 /**
- * @brief Define o tamanho máximo do buffer da fila.
+ * @brief Define o tamanho máximo do buffer da fila (arredondado para cima até uma potência de 2).
  */
 #define MAXLENGTHJQUEUE 5
 #endif
 
 /**
- * @struct jQueue_t
- * @brief Estrutura que representa uma fila genérica.
+ * @brief Menor potência de 2 maior ou igual a n.
+ */
+constexpr uint32_t jQueueCeilPow2(uint32_t n) {
+    return (n <= 1) ? 1 : 2 * jQueueCeilPow2((n + 1) / 2);
+}
+
+/**
+ * @class JQueue
+ * @brief Fila SPSC sem trava de itens do tipo T, com capacidade N (potência de 2).
+ *
+ * Um único contexto pode produzir (send / sendFromISR) e um único contexto pode consumir
+ * (receive / receiveFromISR); os dois podem estar em núcleos diferentes.
+ */
+template <typename T, uint32_t N>
+class JQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "a capacidade de JQueue deve ser potencia de 2");
+
+public:
+    JQueue() : _head(0), _tail(0) {}
+
+    /**
+     * @brief Adiciona uma cópia de item ao fim da fila (lado do produtor).
+     * @return false se a fila estiver cheia.
+     */
+    bool send(const T &item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == N) return false;
+        _buffer[tail & (N - 1)] = item;
+        _tail.store(tail + 1, std::memory_order_release); // publica o item
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Adiciona até n itens de uma vez, com uma única publicação do índice (lado do produtor).
+     * @return Número de itens efetivamente adicionados (menos que n se a fila encher).
+     */
+    uint32_t sendN(const T *items, uint32_t n) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t space = N - (tail - _head.load(std::memory_order_acquire));
+        if (n > space) n = space;
+        if (n == 0) return 0;
+        for (uint32_t i = 0; i < n; i++) _buffer[(tail + i) & (N - 1)] = items[i];
+        _tail.store(tail + n, std::memory_order_release);
+        wake();
+        return n;
+    }
+
+    /**
+     * @brief Igual a send(); não bloqueia nem usa seções críticas, podendo ser chamada de uma ISR.
+     */
+    bool sendFromISR(const T &item) { return send(item); }
+
+    /**
+     * @brief Remove o item mais antigo da fila (lado do consumidor).
+     * @param item Recebe uma cópia do item.
+     * @return false se a fila estiver vazia.
+     */
+    bool receive(T &item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) return false;
+        item = _buffer[head & (N - 1)];
+        _head.store(head + 1, std::memory_order_release); // libera a posição para o produtor
+        return true;
+    }
+
+    /**
+     * @brief Remove até n itens de uma vez, com uma única liberação do índice (lado do consumidor).
+     * @return Número de itens copiados para items.
+     */
+    uint32_t receiveN(T *items, uint32_t n) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t avail = _tail.load(std::memory_order_acquire) - head;
+        if (n > avail) n = avail;
+        if (n == 0) return 0;
+        for (uint32_t i = 0; i < n; i++) items[i] = _buffer[(head + i) & (N - 1)];
+        _head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Remove um item, esperando até timeoutMs milissegundos se a fila estiver vazia.
+     *
+     * Só pode ser chamada de uma task (nunca de uma ISR), e por um único consumidor.
+     * @return false se o tempo esgotar sem que chegue um item.
+     */
+    bool receiveWait(T &item, uint32_t timeoutMs) {
+        return receiveNWait(&item, 1, timeoutMs) == 1;
+    }
+
+    /**
+     * @brief Como receiveN(), mas espera até timeoutMs milissegundos pelo primeiro item.
+     * @return Número de itens copiados (0 se o tempo esgotar).
+     */
+    uint32_t receiveNWait(T *items, uint32_t n, uint32_t timeoutMs) {
+        uint32_t got = receiveN(items, n);
+        if (got || n == 0 || timeoutMs == 0) return got;
+#ifdef ARDUINO
+        _waiter = xTaskGetCurrentTaskHandle();
+        _waiting.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        TickType_t start = xTaskGetTickCount();
+        TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+        // Notificações antigas podem acordar cedo demais: confere a fila e espera o restante.
+        while ((got = receiveN(items, n)) == 0) {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= ticks) break;
+            ulTaskNotifyTakeIndexed(JQUEUE_NOTIFY_INDEX, pdTRUE, ticks - elapsed);
+        }
+        _waiting.store(false, std::memory_order_relaxed);
+#else
+        std::unique_lock<std::mutex> lock(_mtx);
+        _waiting.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        _cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return (got = receiveN(items, n)) != 0; });
+        _waiting.store(false, std::memory_order_relaxed);
+#endif
+        return got;
+    }
+
+    /**
+     * @brief Igual a receive(); pode ser chamada de uma ISR que seja a única consumidora.
+     */
+    bool receiveFromISR(T &item) { return receive(item); }
+
+    /**
+     * @brief Copia o item mais antigo sem removê-lo (lado do consumidor).
+     * @return false se a fila estiver vazia.
+     */
+    bool peek(T &item) const {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) return false;
+        item = _buffer[head & (N - 1)];
+        return true;
+    }
+
+    /**
+     * @brief Descarta todos os itens (lado do consumidor).
+     */
+    void clear() {
+        _head.store(_tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /**
+     * @brief Número de itens na fila (instantâneo; pode mudar logo em seguida).
+     */
+    uint32_t size() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= N; }
+    static constexpr uint32_t capacity() { return N; }
+
+private:
+    /**
+     * @brief Acorda o consumidor bloqueado em receiveWait(), se houver.
+     */
+    void wake() {
+        // Par da barreira em receiveNWait(): ou o consumidor vê o item, ou aqui se vê _waiting.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!_waiting.load(std::memory_order_relaxed)) return;
+#ifdef ARDUINO
+        if (xPortInIsrContext()) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveIndexedFromISR(_waiter, JQUEUE_NOTIFY_INDEX, &woken);
+            if (woken) portYIELD_FROM_ISR();
+        } else {
+            xTaskNotifyGiveIndexed(_waiter, JQUEUE_NOTIFY_INDEX);
+        }
+#else
+        { std::lock_guard<std::mutex> lock(_mtx); }  // o consumidor já está no wait ou ainda vai conferir a fila
+        _cv.notify_one();
+#endif
+    }
+
+    T _buffer[N];
+    std::atomic<uint32_t> _head; ///< Próximo item a ser lido (escrito só pelo consumidor).
+    std::atomic<uint32_t> _tail; ///< Próxima posição a ser escrita (escrita só pelo produtor).
+    std::atomic<bool> _waiting{false}; ///< Consumidor bloqueado em receiveWait().
+#ifdef ARDUINO
+    TaskHandle_t _waiter = nullptr;
+#else
+    std::mutex _mtx;
+    std::condition_variable _cv;
+#endif
+};
+
+/**
+ * @class JQueueMPSC
+ * @brief Fila sem trava de vários produtores e um consumidor, com capacidade N (potência de 2).
+ *
+ * send() pode ser chamada ao mesmo tempo de ISRs e tasks nos dois núcleos; receive() só de
+ * um consumidor. Um produtor interrompido entre reservar a posição e publicar o item apenas
+ * atrasa o consumidor naquela posição; os demais produtores continuam.
  */
-typedef struct {
-    void *buffer[MAXLENGTHJQUEUE]; ///< Buffer para armazenar endereços de itens na fila.
-    uint8_t head; ///< Índice do próximo item a ser lido.
-    uint8_t tail; ///< Índice do próximo espaço disponível para escrita.
-    uint8_t count; ///< Número atual de itens na fila.
-} jQueue_t;
+template <typename T, uint32_t N>
+class JQueueMPSC {
+    static_assert(N > 1 && (N & (N - 1)) == 0, "a capacidade de JQueueMPSC deve ser potencia de 2");
+
+public:
+    JQueueMPSC() : _enqueue(0), _dequeue(0), _drops(0) {
+        for (uint32_t i = 0; i < N; i++) _cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adiciona uma cópia de item (qualquer produtor, inclusive ISR).
+     * @return false se a fila estiver cheia (contado em drops()).
+     */
+    bool send(const T &item) {
+        uint32_t pos = _enqueue.load(std::memory_order_relaxed);
+        Cell_t *cell;
+        for (;;) {
+            cell = &_cells[pos & (N - 1)];
+            int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                // Posição livre nesta volta: tenta reservá-la (pos é atualizado se outro ganhar).
+                if (_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                _drops.fetch_add(1, std::memory_order_relaxed); // consumidor ainda não liberou
+                return false;
+            } else {
+                pos = _enqueue.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = item;
+        cell->seq.store(pos + 1, std::memory_order_release); // publica para o consumidor
+        return true;
+    }
+
+    /**
+     * @brief Igual a send(); pode ser chamada de uma ISR.
+     */
+    bool sendFromISR(const T &item) { return send(item); }
+
+    /**
+     * @brief Remove o item mais antigo (apenas o consumidor).
+     * @return false se a fila estiver vazia ou o próximo item ainda não tiver sido publicado.
+     */
+    bool receive(T &item) {
+        uint32_t pos = _dequeue.load(std::memory_order_relaxed);
+        Cell_t &cell = _cells[pos & (N - 1)];
+        if ((int32_t)(cell.seq.load(std::memory_order_acquire) - (pos + 1)) < 0) return false;
+        item = cell.data;
+        cell.seq.store(pos + N, std::memory_order_release); // libera a posição para a próxima volta
+        _dequeue.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Remove até n itens (apenas o consumidor).
+     * @return Número de itens copiados.
+     */
+    uint32_t receiveN(T *items, uint32_t n) {
+        uint32_t got = 0;
+        while (got < n && receive(items[got])) got++;
+        return got;
+    }
+
+    /**
+     * @brief Número aproximado de itens reservados ou na fila.
+     */
+    uint32_t size() const {
+        return _enqueue.load(std::memory_order_relaxed) - _dequeue.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr uint32_t capacity() { return N; }
+
+    /**
+     * @brief Número de envios recusados por fila cheia desde o início (ou o último resetDrops()).
+     */
+    uint32_t drops() const { return _drops.load(std::memory_order_relaxed); }
+    void resetDrops() { _drops.store(0, std::memory_order_relaxed); }
+
+private:
+    struct Cell_t {
+        std::atomic<uint32_t> seq; ///< pos: livre para o produtor pos; pos + 1: item publicado.
+        T data;
+    };
+
+    Cell_t _cells[N];
+    std::atomic<uint32_t> _enqueue; ///< Próxima posição a reservar (disputada pelos produtores).
+    std::atomic<uint32_t> _dequeue; ///< Próxima posição a ler (só o consumidor escreve).
+    std::atomic<uint32_t> _drops;
+};
+
+/**
+ * @brief Fila genérica da API antiga: endereços de itens, capacidade MAXLENGTHJQUEUE arredondada.
+ *
+ * Atenção: a capacidade é arredondada para a potência de 2 seguinte, então com o padrão 5 a
+ * fila guarda 8 itens (a jQueue_t original guardava 5 e recusava o sexto).
+ */
+typedef JQueue<void *, jQueueCeilPow2(MAXLENGTHJQUEUE)> jQueue_t;
 
 /**
  * @brief Inicializa uma fila genérica.
@@ -36,9 +373,7 @@ typedef struct {
  * @param queue Ponteiro para a estrutura da fila.
  */
 void jQueueInit(jQueue_t *queue) {
-    queue->head = 0;
-    queue->tail = 0;
-    queue->count = 0;
+    new (queue) jQueue_t();
 }
 
 /**
@@ -49,13 +384,7 @@ void jQueueInit(jQueue_t *queue) {
  * @return true se o item foi adicionado com sucesso, false caso a fila esteja cheia.
  */
 bool jQueueSendFromISR(jQueue_t *queue, void *item) {
-    if (queue->count == MAXLENGTHJQUEUE) return false; // Verifica se a fila está cheia.
-    //noInterrupts();
-    queue->buffer[queue->tail] = item;
-    queue->tail = (queue->tail + 1) % MAXLENGTHJQUEUE;
-    queue->count++;
-    //interrupts();
-    return true;
+    return queue->sendFromISR(item);
 }
 
 /**
@@ -66,13 +395,43 @@ bool jQueueSendFromISR(jQueue_t *queue, void *item) {
  * @return true se o item foi removido com sucesso, false caso a fila esteja vazia.
  */
 bool jQueueReceive(jQueue_t *queue, void **item) {
-    if (queue->count == 0) return false; // Verifica se a fila está vazia.
-    //noInterrupts();
-    *item = queue->buffer[queue->head];
-    queue->head = (queue->head + 1) % MAXLENGTHJQUEUE;
-    queue->count--;
-    //interrupts();
-    return true;
+    return queue->receive(*item);
+}
+
+/**
+ * @brief Adiciona vários itens à fila a partir de uma ISR.
+ *
+ * @param queue Ponteiro para a estrutura da fila.
+ * @param items Vetor de ponteiros a adicionar.
+ * @param n Número de itens em items.
+ * @return Número de itens adicionados (menos que n se a fila encher).
+ */
+uint8_t jQueueSendNFromISR(jQueue_t *queue, void *const *items, uint8_t n) {
+    return (uint8_t)queue->sendN(items, n);
+}
+
+/**
+ * @brief Remove vários itens da fila de uma vez.
+ *
+ * @param queue Ponteiro para a estrutura da fila.
+ * @param items Vetor que recebe os itens removidos.
+ * @param n Número máximo de itens a remover.
+ * @return Número de itens removidos.
+ */
+uint8_t jQueueReceiveN(jQueue_t *queue, void **items, uint8_t n) {
+    return (uint8_t)queue->receiveN(items, n);
+}
+
+/**
+ * @brief Remove um item da fila, esperando até timeoutMs milissegundos se ela estiver vazia.
+ *
+ * @param queue Ponteiro para a estrutura da fila.
+ * @param item Ponteiro para armazenar o item removido.
+ * @param timeoutMs Tempo máximo de espera (não usar em ISR).
+ * @return true se um item foi removido, false se o tempo esgotou.
+ */
+bool jQueueReceiveWait(jQueue_t *queue, void **item, uint32_t timeoutMs) {
+    return queue->receiveWait(*item, timeoutMs);
 }
 
 /**
@@ -81,7 +440,7 @@ bool jQueueReceive(jQueue_t *queue, void **item) {
  * @return true se a fila estiver vazia, false caso contrário.
  */
 bool jQueueIsEmpty(const jQueue_t *queue) {
-    return queue->count == 0;
+    return queue->empty();
 }
 
 /**
@@ -90,7 +449,7 @@ bool jQueueIsEmpty(const jQueue_t *queue) {
  * @return true se a fila estiver cheia, false caso contrário.
  */
 bool jQueueIsFull(const jQueue_t *queue) {
-    return queue->count == MAXLENGTHJQUEUE;
+    return queue->full();
 }
 
 /**
@@ -99,7 +458,7 @@ bool jQueueIsFull(const jQueue_t *queue) {
  * @return Número de itens na fila.
  */
 uint8_t jQueueSize(const jQueue_t *queue) {
-    return queue->count;
+    return (uint8_t)queue->size();
 }
 
 #endif
@@ -7,9 +7,55 @@
  *
  * Este arquivo implementa a estrutura para configurar, agendar e executar tarefas
  * utilizando a função micros() no loop principal, dispensando tanto a interrupção de timer quanto a fila.
+ *
+ * As tarefas ficam em um min-heap ordenado pelo próximo instante de execução, então cada
+ * passagem de jtaskLoop() só olha a tarefa mais urgente, e jtaskNextWakeup() informa quanto
+ * tempo falta para ela (permitindo dormir em vez de girar o loop).
+ *
+ * O agendamento é travado em fase (next += period): um atraso num disparo não desloca os
+ * seguintes. Quando a tarefa perde um ou mais períodos inteiros, a política de overrun
+ * (jtaskOverrun_t) decide o que fazer, e cada tarefa registra o jitter de liberação
+ * (atraso entre o instante previsto e o disparo real) e a contagem de prazos perdidos.
+ *
+ * As tarefas podem ser funções simples (jtaskAttachFunc), funções com ponteiro de contexto ou
+ * pequenos objetos chamáveis guardados dentro da própria entrada (jtaskAttach), e podem ser
+ * removidas em tempo de execução (jtaskDetach). As entradas vêm de um pool de blocos fixos
+ * dimensionado uma única vez (NUMTASKS, ou jtaskSetup(capacidade)); depois disso o
+ * escalonador nunca usa o heap.
+ *
+ * Tarefas que vencem na mesma passagem rodam em ordem de prioridade: primeiro o campo
+ * priority (menor = mais urgente, padrão JTASK_PRIO_DEFAULT) e, em empate, o menor período
+ * (rate-monotonic). Cada tarefa tem um prazo relativo (padrão: o próprio período); ao terminar
+ * depois dele, stats.deadlineMisses é incrementado e jtaskOnDeadlineMiss é chamado.
+ * jtaskSchedulable() usa os piores tempos de execução medidos para uma análise de tempo de
+ * resposta não preemptiva, indicando se o conjunto cumpre todos os prazos.
+ *
+ * A medição de prazo e de pior caso (stats.execMax, stats.deadlineMisses) fica sob
+ * JTASK_TIMING (padrão 1) e custa duas leituras do relógio por execução (micros(), menos de
+ * 1 µs no ESP32). Com JTASK_TIMING 0 essas estatísticas ficam em zero e jtaskSchedulable()
+ * não tem dados para a análise.
+ *
+ * Com JTASK_PROFILE definido como 1, cada chamada de task() é cronometrada: histograma do
+ * tempo de execução, pior caso, número de chamadas e fração de CPU por tarefa e total
+ * (jtaskProfileSnapshot()). Com JTASK_PROFILE 0 (padrão) nada disso é compilado; com
+ * JTASK_PROFILE 0 e JTASK_TIMING 0 jtaskRun() só chama a tarefa, sem custo algum.
+ *
+ * Fora do Arduino (ex.: testes no PC) o relógio padrão é o std::chrono::steady_clock, e
+ * qualquer relógio pode ser injetado com jtaskSetClock().
  */
 
+#ifdef ARDUINO
 #include "Arduino.h"
+#else
+#include <stdint.h>
+#include <chrono>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <type_traits>
+#include <utility>
 
 #ifndef NUMTASKS
   /**
@@ -18,6 +64,145 @@
   #define NUMTASKS 2
 #endif
 
+#ifndef JTASK_INLINE_SIZE
+  /**
+   * @brief Espaço (bytes) para guardar um objeto chamável dentro da entrada da tarefa.
+   */
+  #define JTASK_INLINE_SIZE 16
+#endif
+
+#ifndef JTASK_PROFILE
+  /**
+   * @brief Ativa (1) a instrumentação de tempo de execução das tarefas.
+   */
+  #define JTASK_PROFILE 0
+#endif
+
+#ifndef JTASK_TIMING
+  /**
+   * @brief Ativa (1) a medição de pior caso e de prazos perdidos (duas leituras do relógio por execução).
+   */
+  #define JTASK_TIMING 1
+#endif
+
+#ifndef JTASK_PROFILE_BUCKETS
+  /**
+   * @brief Número de faixas do histograma: [0,1), [1,2), [2,4), ... µs; a última acumula o resto.
+   */
+  #define JTASK_PROFILE_BUCKETS 12
+#endif
+
+#ifndef JTASK_PRIO_DEFAULT
+  /**
+   * @brief Prioridade inicial das tarefas (0 = mais urgente); com todas iguais vale o rate-monotonic.
+   */
+  #define JTASK_PRIO_DEFAULT 128
+#endif
+
+/**
+ * @brief Valor retornado por jtaskNextWakeup() quando não há tarefas registradas.
+ */
+#define JTASK_NO_TASK ((unsigned long)-1)
+
+/**
+ * @brief Afinidade padrão: a tarefa pode rodar em qualquer núcleo (ver jtaskPool.h).
+ */
+#define JTASK_ANY_CORE (-1)
+
+/**
+ * @brief Identificador inválido retornado por jtaskAttach() quando o pool está cheio.
+ */
+#define JTASK_INVALID (-1)
+
+/**
+ * @brief Marca de fim da lista de entradas livres.
+ */
+#define JTASK_NO_SLOT 0xFF
+
+/**
+ * @brief Política aplicada quando uma tarefa perde um ou mais períodos inteiros.
+ */
+enum jtaskOverrun_t : uint8_t {
+  JTASK_SKIP,     ///< Executa uma vez e pula os períodos perdidos, mantendo a fase original.
+  JTASK_CATCH_UP, ///< Executa todos os períodos perdidos (um por passagem) até alcançar o relógio.
+  JTASK_REALIGN   ///< Executa uma vez e realinha a fase no instante atual (comportamento antigo).
+};
+
+/**
+ * @struct TaskStats_t
+ * @brief Estatísticas de jitter de liberação de uma tarefa (em microssegundos).
+ *
+ * @param jitterMin Menor atraso observado entre o instante previsto e o disparo.
+ * @param jitterMax Maior atraso observado.
+ * @param jitterSum Soma dos atrasos (para a média).
+ * @param runs Número de disparos considerados.
+ * @param missed Número de liberações perdidas ou iniciadas com mais de um período de atraso.
+ * @param execMax Pior tempo de execução observado (usado por jtaskSchedulable(); só com JTASK_TIMING).
+ * @param deadlineMisses Número de execuções terminadas depois do prazo (só com JTASK_TIMING).
+ */
+struct TaskStats_t {
+  unsigned long jitterMin;
+  unsigned long jitterMax;
+  uint64_t jitterSum;
+  uint32_t runs;
+  uint32_t missed;
+  unsigned long execMax;
+  uint32_t deadlineMisses;
+};
+
+#if JTASK_PROFILE
+/**
+ * @struct TaskProfile_t
+ * @brief Medidas de tempo de execução de uma tarefa (em microssegundos).
+ *
+ * @param calls Número de execuções na janela atual.
+ * @param execSum Tempo total de execução na janela.
+ * @param execMax Pior caso observado.
+ * @param hist Histograma logarítmico do tempo de execução.
+ */
+struct TaskProfile_t {
+  uint32_t calls;
+  uint64_t execSum;
+  unsigned long execMax;
+  uint32_t hist[JTASK_PROFILE_BUCKETS];
+};
+#endif
+
+/**
+ * @brief Tipo da função de relógio usada pelo escalonador (em microssegundos).
+ */
+typedef unsigned long (*jtaskClock_t)();
+
+/**
+ * @brief Relógio padrão: micros() no Arduino, steady_clock no host.
+ */
+unsigned long jtaskDefaultClock() {
+#ifdef ARDUINO
+  return micros();
+#else
+  using namespace std::chrono;
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Relógio atualmente em uso pelo escalonador.
+ */
+jtaskClock_t jtaskClock = jtaskDefaultClock;
+
+/**
+ * @brief Correção somada ao relógio, para o tempo em que ele ficou parado num sono
+ * (ver jtaskIdle.h). Permanece 0 com relógios que continuam contando durante o sono.
+ */
+unsigned long jtaskClockSkew = 0;
+
+/**
+ * @brief Tempo atual do escalonador, em microssegundos.
+ */
+inline unsigned long jtaskNow() {
+  return jtaskClock() + jtaskClockSkew;
+}
+
 /**
  * @brief Índice para rastrear o número de tarefas registradas.
  */
@@ -29,26 +214,329 @@ uint8_t jtaskIndex = 0;
  *
  * @param lastExec Instante (em microssegundos) da última execução.
  * @param period Período da tarefa (em microssegundos).
- * @param task Ponteiro para a função que representa a tarefa.
+ * @param task Ponteiro para a função que representa a tarefa (registro por jtaskAttachFunc).
+ * @param nextExec Instante (em microssegundos) da próxima liberação prevista.
+ * @param policy Política de overrun.
+ * @param core Núcleo em que a tarefa deve rodar no modo executor (JTASK_ANY_CORE = qualquer).
+ * @param active Indica se a entrada está em uso (atômico: lido pelos workers do modo executor).
+ * @param heapPos Posição da entrada no heap de prazos.
+ * @param nextFree Próxima entrada livre (apenas enquanto a entrada está no pool).
+ * @param priority Prioridade (0 = mais urgente); empates são decididos pelo menor período.
+ * @param deadline Prazo relativo à liberação (em microssegundos); 0 = igual ao período.
+ * @param release Instante previsto da liberação em execução (referência do prazo).
+ * @param fn Função chamada a cada liberação, recebendo ctx.
+ * @param ctx Contexto passado a fn.
+ * @param destroy Destrutor do objeto chamável guardado em store (ou nullptr).
+ * @param store Espaço para um objeto chamável pequeno.
+ * @param stats Estatísticas de jitter e prazos perdidos.
+ * @param prof Perfil de execução (apenas com JTASK_PROFILE).
  */
 struct TaskConfig_t {
   unsigned long lastExec;
   unsigned long period;
   void (*task)();
+  unsigned long nextExec;
+  jtaskOverrun_t policy;
+  int8_t core;
+  std::atomic<bool> active;
+  uint8_t heapPos;
+  uint8_t nextFree;
+  uint8_t priority;
+  unsigned long deadline;
+  unsigned long release;
+  void (*fn)(void *ctx);
+  void *ctx;
+  void (*destroy)(void *ctx);
+  alignas(8) unsigned char store[JTASK_INLINE_SIZE];
+  TaskStats_t stats;
+#if JTASK_PROFILE
+  TaskProfile_t prof;
+#endif
+};
+
+/**
+ * @brief Pool estático usado quando a capacidade não passa de NUMTASKS.
+ */
+TaskConfig_t jtaskStaticStruct[NUMTASKS];
+uint8_t jtaskStaticHeap[NUMTASKS];
+
+/**
+ * @struct jtaskDue_t
+ * @brief Tarefa vencida numa passagem de jtaskLoop(), com o instante previsto da liberação.
+ */
+struct jtaskDue_t {
+  unsigned long release;
+  uint8_t index;
 };
+jtaskDue_t jtaskStaticDue[NUMTASKS];
+
+/**
+ * @brief Entradas das tarefas (pool de blocos fixos), indexadas pelo identificador da tarefa.
+ */
+TaskConfig_t *jtaskStruct = jtaskStaticStruct;
+
+/**
+ * @brief Min-heap de identificadores, ordenado por nextExec. Os jtaskIndex primeiros são válidos.
+ */
+uint8_t *jtaskHeap = jtaskStaticHeap;
+
+/**
+ * @brief Tarefas vencidas na passagem atual, em ordem de prioridade.
+ */
+jtaskDue_t *jtaskDue = jtaskStaticDue;
+
+/**
+ * @brief Número de entradas do pool.
+ */
+uint8_t jtaskCapacity = NUMTASKS;
+
+/**
+ * @brief Primeira entrada livre do pool (JTASK_NO_SLOT se cheio).
+ */
+uint8_t jtaskFreeHead = JTASK_NO_SLOT;
+
+/**
+ * @brief Indica se a lista de entradas livres já foi montada.
+ */
+bool jtaskPoolReady = false;
+
+/**
+ * @brief Executor opcional (ver jtaskPool.h).
+ *
+ * Se definido, jtaskLoop() entrega cada tarefa vencida a esta função em vez de executá-la,
+ * junto com o instante previsto da liberação (a ser gravado em release antes de executar).
+ * Ela deve retornar false se a tarefa ainda estiver pendente de uma liberação anterior,
+ * caso em que a liberação conta como perdida.
+ */
+bool (*jtaskDispatch)(uint8_t index, unsigned long release) = nullptr;
+
+/**
+ * @brief Espera o executor largar uma entrada (ver jtaskPool.h).
+ *
+ * Chamada por jtaskDetach() depois de desativar a entrada e antes de destruir o contexto:
+ * retorna quando nenhum worker estiver executando nem prestes a executar a tarefa.
+ */
+void (*jtaskQuiesce)(uint8_t index) = nullptr;
+
+/**
+ * @brief Callback opcional chamado quando uma tarefa termina depois do prazo.
+ *
+ * Recebe o identificador da tarefa e o tempo de resposta (da liberação prevista ao fim).
+ * No modo executor é chamado pelo worker que executou a tarefa.
+ */
+void (*jtaskOnDeadlineMiss)(uint8_t index, unsigned long response) = nullptr;
+
+#if JTASK_PROFILE
+/**
+ * @brief Início da janela de medição atual.
+ */
+unsigned long jtaskProfStart = 0;
+
+/**
+ * @brief Registra uma execução de duração dt na tarefa index.
+ */
+inline void jtaskProfileRecord(uint8_t index, unsigned long dt) {
+  TaskProfile_t &p = jtaskStruct[index].prof;
+  p.calls++;
+  p.execSum += dt;
+  if (dt > p.execMax) p.execMax = dt;
+  uint8_t b = 0;
+  while (dt && b < JTASK_PROFILE_BUCKETS - 1) {  // b = 1 + floor(log2(dt))
+    dt >>= 1;
+    b++;
+  }
+  p.hist[b]++;
+}
+
+/**
+ * @brief Zera os perfis e inicia uma nova janela de medição.
+ */
+void jtaskProfileReset() {
+  for (uint8_t i = 0; i < jtaskCapacity; i++) jtaskStruct[i].prof = TaskProfile_t{};
+  jtaskProfStart = jtaskNow();
+}
 
 /**
- * @brief Array que armazena as configurações das tarefas.
+ * @brief Fração de CPU (0 a 1) usada por uma tarefa desde o início da janela.
+ * @param index Índice da tarefa, ou JTASK_NO_TASK para o total de todas as tarefas.
  */
-TaskConfig_t jtaskStruct[NUMTASKS];
+float jtaskProfileLoad(unsigned long index) {
+  unsigned long window = jtaskNow() - jtaskProfStart;
+  if (window == 0) return 0.0f;
+  uint64_t busy = 0;
+  for (uint8_t i = 0; i < jtaskCapacity; i++)
+    if (jtaskStruct[i].active && (index == JTASK_NO_TASK || index == i)) busy += jtaskStruct[i].prof.execSum;
+  return (float)busy / window;
+}
+
+/**
+ * @brief Escreve um resumo compacto dos perfis, pronto para wserial::println().
+ *
+ * Formato: "JP:<janela ms>:<CPU total ‰>|<id>:<chamadas>:<médio µs>:<máx µs>:<CPU ‰>:<h0>,<h1>,...|..."
+ * @param buf Buffer de saída.
+ * @param len Tamanho do buffer.
+ * @return Número de caracteres escritos (truncado se o buffer for pequeno).
+ */
+size_t jtaskProfileSnapshot(char *buf, size_t len) {
+  if (len == 0) return 0;
+  size_t pos = 0;
+  auto put = [&](int n) { if (n > 0) pos = (pos + n < len) ? pos + n : len - 1; };
+  put(snprintf(buf, len, "JP:%lu:%u", (unsigned long)((jtaskNow() - jtaskProfStart) / 1000),
+               (unsigned)(jtaskProfileLoad(JTASK_NO_TASK) * 1000)));
+  for (uint8_t i = 0; i < jtaskCapacity; i++) {
+    if (!jtaskStruct[i].active) continue;
+    const TaskProfile_t &p = jtaskStruct[i].prof;
+    put(snprintf(buf + pos, len - pos, "|%u:%u:%lu:%lu:%u:", i, (unsigned)p.calls,
+                 (unsigned long)(p.calls ? p.execSum / p.calls : 0), p.execMax,
+                 (unsigned)(jtaskProfileLoad(i) * 1000)));
+    for (uint8_t b = 0; b < JTASK_PROFILE_BUCKETS; b++)
+      put(snprintf(buf + pos, len - pos, b ? ",%u" : "%u", (unsigned)p.hist[b]));
+  }
+  return pos;
+}
+#endif
+
+/**
+ * @brief Compara dois instantes tratando o overflow do relógio de 32 bits.
+ * @return true se a ocorre antes de b.
+ */
+inline bool jtaskBefore(unsigned long a, unsigned long b) {
+  return (long)(a - b) < 0;
+}
+
+/**
+ * @brief Sobe o elemento da posição pos até restaurar a ordem do heap.
+ */
+void jtaskSiftUp(uint8_t pos) {
+  uint8_t item = jtaskHeap[pos];
+  while (pos > 0) {
+    uint8_t parent = (pos - 1) / 2;
+    if (!jtaskBefore(jtaskStruct[item].nextExec, jtaskStruct[jtaskHeap[parent]].nextExec)) break;
+    jtaskHeap[pos] = jtaskHeap[parent];
+    jtaskStruct[jtaskHeap[pos]].heapPos = pos;
+    pos = parent;
+  }
+  jtaskHeap[pos] = item;
+  jtaskStruct[item].heapPos = pos;
+}
+
+/**
+ * @brief Desce o elemento da posição pos até restaurar a ordem do heap.
+ */
+void jtaskSiftDown(uint8_t pos) {
+  uint8_t item = jtaskHeap[pos];
+  for (;;) {
+    unsigned child = 2u * pos + 1;
+    if (child >= jtaskIndex) break;
+    if (child + 1 < jtaskIndex &&
+        jtaskBefore(jtaskStruct[jtaskHeap[child + 1]].nextExec, jtaskStruct[jtaskHeap[child]].nextExec))
+      child++;
+    if (!jtaskBefore(jtaskStruct[jtaskHeap[child]].nextExec, jtaskStruct[item].nextExec)) break;
+    jtaskHeap[pos] = jtaskHeap[child];
+    jtaskStruct[jtaskHeap[pos]].heapPos = pos;
+    pos = child;
+  }
+  jtaskHeap[pos] = item;
+  jtaskStruct[item].heapPos = pos;
+}
+
+/**
+ * @brief Monta a lista de entradas livres em ordem crescente.
+ */
+void jtaskInitPool() {
+  for (uint8_t i = 0; i < jtaskCapacity; i++) {
+    jtaskStruct[i].active = false;
+    jtaskStruct[i].nextFree = (i + 1 < jtaskCapacity) ? i + 1 : JTASK_NO_SLOT;
+  }
+  jtaskFreeHead = jtaskCapacity ? 0 : JTASK_NO_SLOT;
+  jtaskPoolReady = true;
+}
 
 /**
  * @brief Inicializa o sistema de tarefas.
  *
- * Esta função pode ser utilizada para futuras inicializações, se necessário.
+ * Sem argumento usa o pool estático de NUMTASKS entradas. Com uma capacidade maior, o pool
+ * é alocado aqui, uma única vez, e o escalonador não volta a usar o heap. Deve ser chamada
+ * antes de registrar qualquer tarefa.
+ * @param capacity Número máximo de tarefas simultâneas (até 254).
+ * @return false se já houver tarefas registradas ou se a alocação falhar.
+ */
+bool jtaskSetup(uint8_t capacity = NUMTASKS) {
+  if (jtaskIndex > 0 || capacity == JTASK_NO_SLOT) return false;
+  if (capacity > NUMTASKS) {
+    TaskConfig_t *tasks = (TaskConfig_t *)calloc(capacity, sizeof(TaskConfig_t));
+    uint8_t *heap = (uint8_t *)calloc(capacity, sizeof(uint8_t));
+    jtaskDue_t *due = (jtaskDue_t *)calloc(capacity, sizeof(jtaskDue_t));
+    if (!tasks || !heap || !due) {
+      free(tasks);
+      free(heap);
+      free(due);
+      return false;
+    }
+    if (jtaskStruct != jtaskStaticStruct) {
+      free(jtaskStruct);
+      free(jtaskHeap);
+      free(jtaskDue);
+    }
+    jtaskStruct = tasks;
+    jtaskHeap = heap;
+    jtaskDue = due;
+    jtaskCapacity = capacity;
+  }
+  jtaskInitPool();
+  return true;
+}
+
+/**
+ * @brief Substitui o relógio do escalonador (útil para testes com tempo simulado).
+ * @param clock Função que retorna o tempo atual em microssegundos, ou nullptr para o padrão.
  */
-void jtaskSetup() {
-  // Nenhuma inicialização específica é necessária neste modelo.
+void jtaskSetClock(jtaskClock_t clock) {
+  jtaskClock = clock ? clock : jtaskDefaultClock;
+}
+
+/**
+ * @brief Chama a função legada (sem contexto) de uma entrada.
+ */
+void jtaskCallLegacy(void *ctx) {
+  ((TaskConfig_t *)ctx)->task();
+}
+
+/**
+ * @brief Retira uma entrada do pool, preenche os campos comuns e a insere no heap.
+ * @return Identificador da entrada, ou JTASK_INVALID se o pool estiver cheio.
+ */
+int jtaskAlloc(unsigned long period, jtaskOverrun_t policy) {
+  if (!jtaskPoolReady) jtaskInitPool();
+  if (jtaskFreeHead == JTASK_NO_SLOT) return JTASK_INVALID;  // Verifica se já atingiu o máximo de tarefas
+
+  uint8_t id = jtaskFreeHead;
+  TaskConfig_t &t = jtaskStruct[id];
+  jtaskFreeHead = t.nextFree;
+
+  unsigned long now = jtaskNow();
+  t.lastExec = now;
+  t.period   = period;
+  t.task     = nullptr;
+  t.nextExec = now + period;
+  t.release  = now;
+  t.policy   = policy;
+  t.priority = JTASK_PRIO_DEFAULT;
+  t.deadline = 0;
+  t.core     = JTASK_ANY_CORE;
+  t.fn       = nullptr;
+  t.ctx      = nullptr;
+  t.destroy  = nullptr;
+  t.stats    = TaskStats_t{(unsigned long)-1, 0, 0, 0, 0, 0, 0};
+#if JTASK_PROFILE
+  t.prof = TaskProfile_t{};
+  if (jtaskIndex == 0) jtaskProfStart = now;
+#endif
+  t.active = true;
+  jtaskHeap[jtaskIndex] = id;
+  jtaskIndex++;
+  jtaskSiftUp(jtaskIndex - 1);
+  return id;
 }
 
 /**
@@ -56,35 +544,391 @@ void jtaskSetup() {
  *
  * @param task Ponteiro para a função da tarefa.
  * @param period Período da tarefa (em microssegundos).
+ * @param policy Política de overrun (padrão: JTASK_SKIP).
  * @return true se a tarefa foi registrada com sucesso, false se o número máximo foi atingido.
  *
  * Ao registrar a tarefa, o instante atual é armazenado para controle do período.
  */
-bool jtaskAttachFunc(void (*task)(), unsigned long period) {
-  if (jtaskIndex >= NUMTASKS) return false;  // Verifica se já atingiu o máximo de tarefas
-  
-  jtaskStruct[jtaskIndex].lastExec = micros();
-  jtaskStruct[jtaskIndex].period   = period;
-  jtaskStruct[jtaskIndex].task     = task;
-  jtaskIndex++;
+bool jtaskAttachFunc(void (*task)(), unsigned long period, jtaskOverrun_t policy = JTASK_SKIP) {
+  int id = jtaskAlloc(period, policy);
+  if (id == JTASK_INVALID) return false;
+  jtaskStruct[id].task = task;
+  jtaskStruct[id].fn   = jtaskCallLegacy;
+  jtaskStruct[id].ctx  = &jtaskStruct[id];
+  return true;
+}
+
+/**
+ * @brief Registra uma tarefa que recebe um ponteiro de contexto.
+ *
+ * Permite várias instâncias da mesma função (ex.: uma por canal) sem variáveis globais.
+ * @param fn Função da tarefa.
+ * @param ctx Contexto repassado a fn a cada execução.
+ * @param period Período da tarefa (em microssegundos).
+ * @param policy Política de overrun (padrão: JTASK_SKIP).
+ * @return Identificador da tarefa, ou JTASK_INVALID se o pool estiver cheio.
+ */
+int jtaskAttach(void (*fn)(void *), void *ctx, unsigned long period, jtaskOverrun_t policy = JTASK_SKIP) {
+  int id = jtaskAlloc(period, policy);
+  if (id == JTASK_INVALID) return JTASK_INVALID;
+  jtaskStruct[id].fn  = fn;
+  jtaskStruct[id].ctx = ctx;
+  return id;
+}
+
+/**
+ * @brief Registra um objeto chamável (ex.: lambda com captura) guardado dentro da entrada.
+ *
+ * O objeto é copiado para o espaço interno da entrada (até JTASK_INLINE_SIZE bytes), sem heap.
+ * @param f Objeto chamável sem argumentos.
+ * @param period Período da tarefa (em microssegundos).
+ * @param policy Política de overrun (padrão: JTASK_SKIP).
+ * @return Identificador da tarefa, ou JTASK_INVALID se o pool estiver cheio.
+ */
+template <typename F>
+int jtaskAttach(F &&f, unsigned long period, jtaskOverrun_t policy = JTASK_SKIP) {
+  typedef typename std::decay<F>::type Fn;
+  static_assert(sizeof(Fn) <= JTASK_INLINE_SIZE, "objeto chamavel maior que JTASK_INLINE_SIZE");
+  static_assert(alignof(Fn) <= 8, "alinhamento do objeto chamavel nao suportado");
+  int id = jtaskAlloc(period, policy);
+  if (id == JTASK_INVALID) return JTASK_INVALID;
+  TaskConfig_t &t = jtaskStruct[id];
+  t.ctx = new (t.store) Fn(std::forward<F>(f));
+  t.fn = [](void *p) { (*(Fn *)p)(); };
+  if (!std::is_trivially_destructible<Fn>::value)
+    t.destroy = [](void *p) { ((Fn *)p)->~Fn(); };
+  return id;
+}
+
+/**
+ * @brief Remove uma tarefa e devolve sua entrada ao pool.
+ *
+ * Pode ser chamada de dentro da própria tarefa. No modo executor (jtaskPool.h) deve ser
+ * chamada na thread de jtaskLoop(), nunca de um worker: ela espera a execução em andamento
+ * da tarefa terminar antes de destruir o contexto e liberar a entrada, e uma liberação que
+ * ainda estava na fila é descartada.
+ * @param id Identificador retornado por jtaskAttach() (ou a ordem de registro de jtaskAttachFunc()).
+ * @return false se o identificador não corresponder a uma tarefa ativa.
+ */
+bool jtaskDetach(int id) {
+  if (id < 0 || id >= jtaskCapacity || !jtaskStruct[id].active) return false;
+  TaskConfig_t &t = jtaskStruct[id];
+
+  uint8_t pos = t.heapPos;
+  jtaskIndex--;
+  if (pos != jtaskIndex) {
+    uint8_t last = jtaskHeap[jtaskIndex];
+    jtaskHeap[pos] = last;
+    jtaskStruct[last].heapPos = pos;
+    jtaskSiftDown(pos);
+    jtaskSiftUp(jtaskStruct[last].heapPos);
+  }
+
+  // Desativa antes de destruir: um worker que ainda tenha a tarefa na fila não a executa, e
+  // jtaskQuiesce espera a execução em andamento, se houver, terminar.
+  t.active.store(false, std::memory_order_release);
+  if (jtaskQuiesce) jtaskQuiesce((uint8_t)id);
+  if (t.destroy) t.destroy(t.ctx);
+  t.nextFree = jtaskFreeHead;
+  jtaskFreeHead = (uint8_t)id;
   return true;
 }
 
+/**
+ * @brief Muda o instante da próxima liberação de uma tarefa.
+ *
+ * A fase passa a contar a partir do novo instante. Pode ser chamada de dentro da própria
+ * tarefa, mas não de um worker do modo executor (o heap pertence à thread de jtaskLoop()).
+ * @param id Identificador da tarefa.
+ * @param at Instante (em microssegundos, no relógio do escalonador) da próxima liberação.
+ * @return false se o identificador não corresponder a uma tarefa ativa.
+ */
+bool jtaskReschedule(int id, unsigned long at) {
+  if (id < 0 || id >= jtaskCapacity || !jtaskStruct[id].active) return false;
+  jtaskStruct[id].nextExec = at;
+  jtaskSiftDown(jtaskStruct[id].heapPos);
+  jtaskSiftUp(jtaskStruct[id].heapPos);
+  return true;
+}
+
+/**
+ * @brief Define a prioridade de uma tarefa.
+ * @param id Identificador da tarefa.
+ * @param priority 0 = mais urgente; tarefas com a mesma prioridade seguem o rate-monotonic.
+ * @return false se o identificador não corresponder a uma tarefa ativa.
+ */
+bool jtaskSetPriority(int id, uint8_t priority) {
+  if (id < 0 || id >= jtaskCapacity || !jtaskStruct[id].active) return false;
+  jtaskStruct[id].priority = priority;
+  return true;
+}
+
+/**
+ * @brief Define o prazo relativo de uma tarefa.
+ * @param id Identificador da tarefa.
+ * @param deadline Tempo máximo entre a liberação prevista e o fim da execução (µs); 0 = período.
+ * @return false se o identificador não corresponder a uma tarefa ativa.
+ */
+bool jtaskSetDeadline(int id, unsigned long deadline) {
+  if (id < 0 || id >= jtaskCapacity || !jtaskStruct[id].active) return false;
+  jtaskStruct[id].deadline = deadline;
+  return true;
+}
+
+/**
+ * @brief Prazo relativo efetivo de uma tarefa (0 se não houver: tarefa de polling sem prazo).
+ */
+inline unsigned long jtaskDeadlineOf(const TaskConfig_t &t) {
+  return t.deadline ? t.deadline : t.period;
+}
+
+/**
+ * @brief Indica se a tarefa a deve rodar antes de b quando ambas vencem juntas.
+ *
+ * Menor priority primeiro; em empate, menor período (rate-monotonic), com as tarefas de
+ * polling (período 0) por último; depois menor prazo e, por fim, menor identificador.
+ */
+inline bool jtaskHigherPriority(uint8_t a, uint8_t b) {
+  const TaskConfig_t &ta = jtaskStruct[a], &tb = jtaskStruct[b];
+  if (ta.priority != tb.priority) return ta.priority < tb.priority;
+  unsigned long pa = ta.period ? ta.period : (unsigned long)-1;
+  unsigned long pb = tb.period ? tb.period : (unsigned long)-1;
+  if (pa != pb) return pa < pb;
+  unsigned long da = jtaskDeadlineOf(ta) - 1, db = jtaskDeadlineOf(tb) - 1;  // 0 (sem prazo) vai para o fim
+  if (da != db) return da < db;
+  return a < b;
+}
+
+/**
+ * @brief Retorna as estatísticas de jitter de uma tarefa.
+ * @param index Identificador da tarefa.
+ * @return Ponteiro para as estatísticas, ou nullptr se o índice for inválido.
+ */
+const TaskStats_t *jtaskStats(uint8_t index) {
+  return (index < jtaskCapacity && jtaskStruct[index].active) ? &jtaskStruct[index].stats : nullptr;
+}
+
+/**
+ * @brief Jitter médio de liberação de uma tarefa, em microssegundos.
+ */
+float jtaskJitterMean(uint8_t index) {
+  const TaskStats_t *st = jtaskStats(index);
+  return (st && st->runs) ? (float)st->jitterSum / st->runs : 0.0f;
+}
+
+/**
+ * @brief Zera as estatísticas de jitter de todas as tarefas.
+ */
+void jtaskResetStats() {
+  for (uint8_t i = 0; i < jtaskCapacity; i++)
+    jtaskStruct[i].stats = TaskStats_t{(unsigned long)-1, 0, 0, 0, 0, 0, 0};
+}
+
+/**
+ * @brief Calcula a próxima liberação de uma tarefa que está sendo disparada agora.
+ *
+ * Mantém a fase (next += period) e aplica a política de overrun quando o atraso
+ * alcança um período inteiro. Também atualiza as estatísticas de jitter.
+ */
+void jtaskRelease(TaskConfig_t &t, unsigned long now) {
+  unsigned long release = t.nextExec;
+  unsigned long late = now - release;
+
+  TaskStats_t &st = t.stats;
+  if (late < st.jitterMin) st.jitterMin = late;
+  if (late > st.jitterMax) st.jitterMax = late;
+  st.jitterSum += late;
+  st.runs++;
+
+  if (t.period == 0) {  // tarefa de polling: roda uma vez por passagem
+    t.nextExec = now + 1;
+    return;
+  }
+  if (late < t.period) {
+    t.nextExec = release + t.period;
+    return;
+  }
+  unsigned long lost = late / t.period;  // períodos inteiros já vencidos além deste
+  switch (t.policy) {
+    case JTASK_CATCH_UP:
+      t.nextExec = release + t.period;
+      st.missed++;
+      break;
+    case JTASK_REALIGN:
+      t.nextExec = now + t.period;
+      st.missed += lost;
+      break;
+    case JTASK_SKIP:
+    default:
+      t.nextExec = release + (lost + 1) * t.period;
+      st.missed += lost;
+      break;
+  }
+}
+
+/**
+ * @brief Executa a tarefa index, mede o tempo de execução e verifica o prazo.
+ *
+ * O prazo é contado a partir de t.release, que deve conter o instante previsto da liberação.
+ * Sem JTASK_TIMING nem JTASK_PROFILE só chama a tarefa.
+ */
+inline void jtaskRun(uint8_t index) {
+  TaskConfig_t &t = jtaskStruct[index];
+#if JTASK_TIMING || JTASK_PROFILE
+  unsigned long start = jtaskNow();
+  t.fn(t.ctx);
+  unsigned long end = jtaskNow();
+  unsigned long exec = end - start;
+#if JTASK_PROFILE
+  jtaskProfileRecord(index, exec);
+#endif
+#if JTASK_TIMING
+  if (exec > t.stats.execMax) t.stats.execMax = exec;
+  unsigned long deadline = jtaskDeadlineOf(t);
+  unsigned long response = end - t.release;
+  if (deadline && response > deadline) {
+    t.stats.deadlineMisses++;
+    if (jtaskOnDeadlineMiss) jtaskOnDeadlineMiss(index, response);
+  }
+#endif
+#else
+  t.fn(t.ctx);
+#endif
+}
+
+/**
+ * @brief Retorna quanto tempo falta para a próxima tarefa vencer.
+ *
+ * Permite ao loop principal dormir (delay, vTaskDelay, light sleep) exatamente até a
+ * próxima tarefa em vez de chamar jtaskLoop() continuamente.
+ * @return Microssegundos até a próxima tarefa (0 se já venceu), ou JTASK_NO_TASK se não há tarefas.
+ */
+unsigned long jtaskNextWakeup() {
+  if (jtaskIndex == 0) return JTASK_NO_TASK;
+  long remaining = (long)(jtaskStruct[jtaskHeap[0]].nextExec - jtaskNow());
+  return remaining > 0 ? (unsigned long)remaining : 0;
+}
+
 /**
  * @brief Atualiza os tempos de execução e executa as tarefas se o período for atingido.
  *
  * Esta função deve ser chamada periodicamente no loop principal do programa.
- * Para cada tarefa registrada, é verificado se o tempo atual menos o instante da última execução
- * é maior ou igual ao período configurado. Se sim, a tarefa é executada imediatamente e o tempo é atualizado.
+ * Apenas o topo do heap é examinado: as tarefas vencidas são retiradas dele, reagendadas e
+ * executadas em ordem de prioridade (jtaskHigherPriority), então o custo por passagem não
+ * cresce com o número de tarefas ociosas. Cada tarefa roda no máximo uma vez por passagem.
  */
 void jtaskLoop() {
-  unsigned long currentMicros = micros();
-  for (uint8_t i = 0; i < jtaskIndex; i++) {
-    if (currentMicros - jtaskStruct[i].lastExec >= jtaskStruct[i].period) {
-      jtaskStruct[i].lastExec = currentMicros;
-      jtaskStruct[i].task();
+  unsigned long currentMicros = jtaskNow();
+
+  // Retira as vencidas do heap, inserindo-as em ordem de prioridade (poucas: inserção direta).
+  uint8_t n = 0;
+  while (jtaskIndex > 0) {
+    uint8_t index = jtaskHeap[0];
+    if (jtaskBefore(currentMicros, jtaskStruct[index].nextExec)) break;
+    jtaskIndex--;
+    if (jtaskIndex > 0) {
+      jtaskHeap[0] = jtaskHeap[jtaskIndex];
+      jtaskSiftDown(0);
+    }
+    uint8_t k = n++;
+    while (k > 0 && jtaskHigherPriority(index, jtaskDue[k - 1].index)) {
+      jtaskDue[k] = jtaskDue[k - 1];
+      k--;
+    }
+    jtaskDue[k].index = index;
+    jtaskDue[k].release = jtaskStruct[index].nextExec;
+  }
+
+  // Reagenda todas antes de executar, para que o heap esteja completo durante as tarefas.
+  for (uint8_t k = 0; k < n; k++) {
+    TaskConfig_t &t = jtaskStruct[jtaskDue[k].index];
+    t.lastExec = currentMicros;
+    jtaskRelease(t, currentMicros);
+    jtaskHeap[jtaskIndex] = jtaskDue[k].index;
+    jtaskIndex++;
+    jtaskSiftUp(jtaskIndex - 1);
+  }
+
+  for (uint8_t k = 0; k < n; k++) {
+    uint8_t index = jtaskDue[k].index;
+    TaskConfig_t &t = jtaskStruct[index];
+    if (!t.active) continue;  // removida por uma tarefa anterior nesta passagem
+    if (!jtaskDispatch) {
+      t.release = jtaskDue[k].release;
+      jtaskRun(index);
+    } else if (!jtaskDispatch(index, jtaskDue[k].release)) {
+      t.stats.missed++;
+    }
+  }
+}
+
+/**
+ * @brief Utilização do processador pelas tarefas periódicas: soma de execMax / período.
+ */
+float jtaskUtilization() {
+  float u = 0.0f;
+  for (uint8_t i = 0; i < jtaskCapacity; i++) {
+    const TaskConfig_t &t = jtaskStruct[i];
+    if (t.active && t.period) u += (float)t.stats.execMax / t.period;
+  }
+  return u;
+}
+
+/**
+ * @brief Verifica se as tarefas periódicas cumprem seus prazos, pelos tempos medidos.
+ *
+ * Análise de tempo de resposta para prioridade fixa não preemptiva (o jtask nunca
+ * interrompe uma tarefa): o início da tarefa i pode esperar uma tarefa de menor prioridade
+ * já em execução (bloqueio B = maior execMax entre elas, incluindo as de polling) e todas as
+ * liberações das de maior prioridade até lá:
+ *
+ *   w = B + soma_j (floor(w / Tj) + 1) * Cj,   R = w + Ci  <=  Di
+ *
+ * O resultado só vale para os piores casos já observados (requer JTASK_TIMING); rode o sistema
+ * sob carga representativa antes de consultar. Ignora o custo do próprio loop e de outras tasks do RTOS.
+ * @param response Vetor opcional de jtaskCapacity posições que recebe o pior tempo de resposta
+ *                 de cada tarefa (JTASK_NO_TASK se ilimitado, 0 se inativa ou sem prazo). Para
+ *                 as que perdem o prazo o valor é apenas o primeiro que o ultrapassou.
+ * @return true se todas as tarefas com prazo terminam a tempo.
+ */
+bool jtaskSchedulable(unsigned long *response = nullptr) {
+  bool ok = jtaskUtilization() <= 1.0f;
+  for (uint8_t i = 0; i < jtaskCapacity; i++) {
+    const TaskConfig_t &ti = jtaskStruct[i];
+    unsigned long deadline = jtaskDeadlineOf(ti);
+    if (response) response[i] = 0;
+    if (!ti.active || deadline == 0) continue;
+
+    uint64_t blocking = 0;
+    bool bounded = true;
+    for (uint8_t j = 0; j < jtaskCapacity; j++) {
+      const TaskConfig_t &tj = jtaskStruct[j];
+      if (j == i || !tj.active) continue;
+      if (jtaskHigherPriority(i, j)) {
+        if (tj.stats.execMax > blocking) blocking = tj.stats.execMax;
+      } else if (tj.period == 0) {
+        bounded = false;  // polling com prioridade maior: interferência sem limite
+      }
     }
+
+    uint64_t w = blocking;
+    while (bounded) {
+      uint64_t next = blocking;
+      for (uint8_t j = 0; j < jtaskCapacity; j++) {
+        const TaskConfig_t &tj = jtaskStruct[j];
+        if (j != i && tj.active && tj.period && jtaskHigherPriority(j, i))
+          next += (w / tj.period + 1) * tj.stats.execMax;
+      }
+      if (next == w) break;
+      w = next;
+      if (w + ti.stats.execMax > deadline) break;  // já perdeu o prazo; não precisa convergir
+    }
+
+    uint64_t r = w + ti.stats.execMax;
+    if (!bounded || r > deadline) ok = false;
+    if (response) response[i] = (bounded && r < JTASK_NO_TASK) ? (unsigned long)r : JTASK_NO_TASK;
   }
+  return ok;
 }
 
-#endif
\ No newline at end of file
+#endif
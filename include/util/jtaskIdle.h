@@ -0,0 +1,156 @@
+#ifndef __JTASKIDLE_H
+#define __JTASKIDLE_H
+
+/**
+ * @file jtaskIdle.h
+ * @brief Ociosidade sem ticks para o jtask: dorme até o próximo prazo em vez de girar o loop.
+ *
+ * jtaskIdle() deve ser chamada logo após jtaskLoop(). Ela consulta jtaskNextWakeup() e,
+ * se não houver E/S pendente, cede a CPU com vTaskDelay() ou entra em light sleep com
+ * despertar por timer, acordando um pouco antes do prazo (wakeLatencyUs).
+ *
+ * Se o relógio do escalonador parar durante o sono, a diferença medida por um relógio de
+ * referência (esp_timer_get_time(), que é compensado no light sleep) é somada a
+ * jtaskClockSkew, mantendo os prazos corretos. A decisão (jtaskIdleDecide) é uma função
+ * pura, e o relógio de referência e a função de sono podem ser injetados para simular o
+ * comportamento no host.
+ *
+ * Uso:
+ *   void loop() {
+ *     IIKit.loop();
+ *     jtaskLoop();
+ *     jtaskIdle();
+ *   }
+ */
+
+#include "jtask.h"
+#ifdef ARDUINO
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#else
+#include <thread>
+#endif
+
+/**
+ * @brief O que fazer enquanto nenhuma tarefa vence.
+ */
+enum jtaskIdleAction_t : uint8_t {
+  JTASK_IDLE_NONE,        ///< Volta ao loop imediatamente.
+  JTASK_IDLE_YIELD,       ///< Cede a CPU (vTaskDelay); o WiFi e as outras tasks continuam.
+  JTASK_IDLE_LIGHT_SLEEP  ///< Light sleep com despertar por timer.
+};
+
+/**
+ * @struct jtaskIdleConfig_t
+ * @brief Limiares da decisão de sono (em microssegundos).
+ *
+ * @param tickUs Granularidade do vTaskDelay() (um tick do FreeRTOS).
+ * @param lightSleepMinUs Espera mínima para valer a pena entrar em light sleep.
+ * @param wakeLatencyUs Antecedência com que se acorda do light sleep.
+ * @param lightSleep Permite light sleep (desligado por padrão: derruba a conexão WiFi).
+ */
+struct jtaskIdleConfig_t {
+  unsigned long tickUs;
+  unsigned long lightSleepMinUs;
+  unsigned long wakeLatencyUs;
+  bool lightSleep;
+};
+
+#ifdef ARDUINO
+jtaskIdleConfig_t jtaskIdleCfg = {portTICK_PERIOD_MS * 1000UL, 20000UL, 2000UL, false};
+#else
+jtaskIdleConfig_t jtaskIdleCfg = {1000UL, 20000UL, 2000UL, false};
+#endif
+
+/**
+ * @brief Predicado opcional: retorna true se houver E/S a tratar (impede o sono).
+ */
+bool (*jtaskIdleIoPending)() = nullptr;
+
+/**
+ * @brief Relógio de referência (µs) que continua contando durante o sono.
+ */
+int64_t jtaskIdleDefaultRefClock() {
+#ifdef ARDUINO
+  return esp_timer_get_time();
+#else
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Executa o sono escolhido.
+ */
+void jtaskIdleDefaultSleep(jtaskIdleAction_t action, unsigned long us) {
+#ifdef ARDUINO
+  if (action == JTASK_IDLE_LIGHT_SLEEP) {
+    esp_sleep_enable_timer_wakeup(us);
+    esp_light_sleep_start();
+  } else {
+    vTaskDelay(us / jtaskIdleCfg.tickUs);
+  }
+#else
+  (void)action;
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+#endif
+}
+
+int64_t (*jtaskIdleRefClock)() = jtaskIdleDefaultRefClock;
+void (*jtaskIdleSleep)(jtaskIdleAction_t action, unsigned long us) = jtaskIdleDefaultSleep;
+
+/**
+ * @brief Tempo total dormido (µs), para estimar o ciclo de trabalho.
+ */
+uint64_t jtaskIdleSleptUs = 0;
+
+/**
+ * @brief Decide como esperar pelo próximo prazo.
+ *
+ * @param wait Microssegundos até o próximo prazo (JTASK_NO_TASK se não há tarefas).
+ * @param ioPending true se houver E/S a tratar.
+ * @param cfg Limiares.
+ * @param sleepUs Duração do sono escolhido (saída).
+ * @return Ação escolhida.
+ */
+jtaskIdleAction_t jtaskIdleDecide(unsigned long wait, bool ioPending, const jtaskIdleConfig_t &cfg,
+                                  unsigned long &sleepUs) {
+  sleepUs = 0;
+  if (ioPending || wait == JTASK_NO_TASK || wait < cfg.tickUs) return JTASK_IDLE_NONE;
+  if (cfg.lightSleep && wait >= cfg.lightSleepMinUs && wait > cfg.wakeLatencyUs) {
+    sleepUs = wait - cfg.wakeLatencyUs;
+    return JTASK_IDLE_LIGHT_SLEEP;
+  }
+  sleepUs = (wait / cfg.tickUs) * cfg.tickUs;  // vTaskDelay só dorme ticks inteiros; nunca passa do prazo
+  return JTASK_IDLE_YIELD;
+}
+
+/**
+ * @brief Dorme até perto do próximo prazo, se nada mais estiver pendente.
+ *
+ * No modo executor (jtaskPool.h) o light sleep é evitado, pois pararia os workers.
+ * @return Microssegundos efetivamente dormidos (0 se voltou direto).
+ */
+unsigned long jtaskIdle() {
+  jtaskIdleConfig_t cfg = jtaskIdleCfg;
+  if (jtaskDispatch) cfg.lightSleep = false;
+
+  unsigned long sleepUs;
+  bool io = jtaskIdleIoPending && jtaskIdleIoPending();
+  jtaskIdleAction_t action = jtaskIdleDecide(jtaskNextWakeup(), io, cfg, sleepUs);
+  if (action == JTASK_IDLE_NONE) return 0;
+
+  int64_t refBefore = jtaskIdleRefClock();
+  unsigned long schedBefore = jtaskNow();
+  jtaskIdleSleep(action, sleepUs);
+  unsigned long refElapsed = (unsigned long)(jtaskIdleRefClock() - refBefore);
+  unsigned long schedElapsed = jtaskNow() - schedBefore;
+
+  // Relógio do escalonador ficou parado durante o sono: compensa. A margem de meio sono
+  // ignora os poucos µs entre as leituras dos dois relógios quando ambos continuam contando.
+  if (refElapsed > schedElapsed + sleepUs / 2) jtaskClockSkew += refElapsed - schedElapsed;
+  jtaskIdleSleptUs += refElapsed;
+  return refElapsed;
+}
+
+#endif
@@ -0,0 +1,322 @@
+#ifndef __JTASKPOOL_H
+#define __JTASKPOOL_H
+
+/**
+ * @file jtaskPool.h
+ * @brief Executor multinúcleo para as tarefas do jtask.
+ *
+ * No modo executor, jtaskLoop() continua decidindo QUANDO cada tarefa vence, mas em vez de
+ * chamá-la no próprio loop a coloca na fila de prontas de um worker (um por núcleo).
+ * Cada tarefa pode ser fixada a um núcleo (jtaskSetAffinity); tarefas sem afinidade vão para
+ * o worker menos ocupado e podem ser roubadas pelo outro núcleo quando este fica ocioso.
+ *
+ * No ESP32 os workers são tasks FreeRTOS fixadas com xTaskCreatePinnedToCore; fora do
+ * Arduino são std::thread, o que permite testar e medir o escalonador no Linux.
+ *
+ * Uso:
+ *   jtaskAttachFunc(displayTask, 50000);
+ *   jtaskAttachFunc(controlTask, 1000);
+ *   jtaskSetAffinity(1, 1);          // controle sempre no núcleo 1
+ *   jtaskPoolBegin();                // a partir daqui jtaskLoop() só despacha
+ *   loop() { jtaskLoop(); }
+ *
+ * Tarefas devem ser registradas e removidas na mesma thread que chama jtaskLoop() (jtaskDetach
+ * espera o worker terminar a execução em andamento antes de liberar a entrada), e
+ * jtaskSetup(capacidade) deve vir antes de jtaskPoolBegin(). Uma tarefa nunca roda em dois
+ * workers ao mesmo tempo: se ela ainda estiver na fila ou executando quando vencer de novo,
+ * a liberação conta como perdida (stats.missed).
+ */
+
+#include "jtask.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#ifndef ARDUINO
+#include <thread>
+#endif
+
+#ifndef JTASK_POOL_CORES
+  /**
+   * @brief Número de workers (um por núcleo).
+   */
+  #define JTASK_POOL_CORES 2
+#endif
+
+#ifndef JTASK_POOL_STACK
+  /**
+   * @brief Tamanho da pilha de cada worker no ESP32 (bytes).
+   */
+  #define JTASK_POOL_STACK 4096
+#endif
+
+#ifndef JTASK_POOL_PRIORITY
+  /**
+   * @brief Prioridade FreeRTOS dos workers no ESP32.
+   */
+  #define JTASK_POOL_PRIORITY 2
+#endif
+
+/**
+ * @brief Marca, para cada tarefa na fila, se ela foi enfileirada sem afinidade (jtaskCapacity
+ * posições). Gravada no despacho e lida ao retirar, para que jtaskSetAffinity() entre os dois
+ * não desequilibre jtaskPoolStealable nem deixe uma tarefa fixada ser roubada.
+ */
+bool *jtaskPoolUnpinned = nullptr;
+
+/**
+ * @struct jtaskReadyQueue_t
+ * @brief Fila de tarefas prontas de um worker.
+ *
+ * O dono retira pela frente; um worker ocioso rouba pelo fim, apenas tarefas sem afinidade.
+ */
+struct jtaskReadyQueue_t {
+  std::mutex mtx;
+  std::condition_variable cv;
+  uint8_t *items = nullptr;  ///< jtaskCapacity posições, alocadas em jtaskPoolBegin()
+  uint8_t head = 0;
+  uint8_t count = 0;
+  std::atomic<bool> idle{true};
+
+  void push(uint8_t index) {
+    std::lock_guard<std::mutex> lock(mtx);
+    items[(head + count) % jtaskCapacity] = index;
+    count++;
+  }
+
+  bool popFront(uint8_t &index) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (count == 0) return false;
+    index = items[head];
+    head = (head + 1) % jtaskCapacity;
+    count--;
+    return true;
+  }
+
+  bool stealBack(uint8_t &index) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (uint8_t k = count; k-- > 0;) {
+      uint8_t pos = (head + k) % jtaskCapacity;
+      if (!jtaskPoolUnpinned[items[pos]]) continue;
+      index = items[pos];
+      for (uint8_t j = k; j + 1 < count; j++)  // fecha o buraco
+        items[(head + j) % jtaskCapacity] = items[(head + j + 1) % jtaskCapacity];
+      count--;
+      return true;
+    }
+    return false;
+  }
+
+  uint8_t size() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return count;
+  }
+
+  void notify() {
+    { std::lock_guard<std::mutex> lock(mtx); }  // evita perder o aviso entre o teste e o wait
+    cv.notify_one();
+  }
+};
+
+/**
+ * @brief Filas de prontas, uma por worker.
+ */
+jtaskReadyQueue_t jtaskPoolQueue[JTASK_POOL_CORES];
+
+/**
+ * @brief Marca as tarefas que estão na fila ou executando (jtaskCapacity posições).
+ */
+std::atomic<bool> *jtaskPoolPending = nullptr;
+
+/**
+ * @brief Número de tarefas sem afinidade aguardando em alguma fila (candidatas a roubo).
+ */
+std::atomic<uint8_t> jtaskPoolStealable{0};
+
+/**
+ * @brief Número de execuções feitas por roubo (diagnóstico).
+ */
+std::atomic<uint32_t> jtaskPoolSteals{0};
+
+std::atomic<bool> jtaskPoolRunning{false};
+std::atomic<uint8_t> jtaskPoolAlive{0};
+
+#ifndef ARDUINO
+std::thread jtaskPoolThreads[JTASK_POOL_CORES];
+#endif
+
+/**
+ * @brief Fixa uma tarefa a um núcleo, ou a libera com JTASK_ANY_CORE.
+ * @param index Identificador da tarefa.
+ * @param core Núcleo (0 a JTASK_POOL_CORES-1) ou JTASK_ANY_CORE.
+ * @return false se o índice ou o núcleo forem inválidos.
+ */
+bool jtaskSetAffinity(uint8_t index, int8_t core) {
+  if (index >= jtaskCapacity || !jtaskStruct[index].active) return false;
+  if (core != JTASK_ANY_CORE && (core < 0 || core >= JTASK_POOL_CORES)) return false;
+  jtaskStruct[index].core = core;
+  return true;
+}
+
+/**
+ * @brief Tenta roubar uma tarefa sem afinidade da fila de outro worker.
+ */
+bool jtaskPoolSteal(uint8_t self, uint8_t &index) {
+  if (jtaskPoolStealable.load(std::memory_order_acquire) == 0) return false;
+  for (uint8_t k = 1; k < JTASK_POOL_CORES; k++) {
+    uint8_t victim = (self + k) % JTASK_POOL_CORES;
+    if (jtaskPoolQueue[victim].stealBack(index)) {
+      jtaskPoolSteals.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Executor instalado em jtaskDispatch: enfileira a tarefa no worker adequado.
+ */
+bool jtaskPoolDispatch(uint8_t index, unsigned long release) {
+  if (jtaskPoolPending[index].exchange(true, std::memory_order_acq_rel)) return false;
+  jtaskStruct[index].release = release;  // só agora: antes disso um worker ainda podia estar lendo
+
+  int8_t core = jtaskStruct[index].core;
+  jtaskPoolUnpinned[index] = core == JTASK_ANY_CORE;  // publicada pelo mutex de push()
+  uint8_t target;
+  if (core != JTASK_ANY_CORE) {
+    target = (uint8_t)core;
+  } else {
+    // Prefere um worker ocioso; senão, a menor fila.
+    target = 0;
+    uint8_t best = 0xFF;
+    for (uint8_t c = 0; c < JTASK_POOL_CORES; c++) {
+      uint8_t load = jtaskPoolQueue[c].size() + (jtaskPoolQueue[c].idle.load() ? 0 : 1);
+      if (load < best) {
+        best = load;
+        target = c;
+      }
+    }
+    jtaskPoolStealable.fetch_add(1, std::memory_order_release);
+  }
+  jtaskPoolQueue[target].push(index);
+  jtaskPoolQueue[target].notify();
+  if (core == JTASK_ANY_CORE)  // acorda os demais para que possam roubar se o alvo estiver ocupado
+    for (uint8_t c = 0; c < JTASK_POOL_CORES; c++)
+      if (c != target && jtaskPoolQueue[c].idle.load()) jtaskPoolQueue[c].notify();
+  return true;
+}
+
+/**
+ * @brief Instalado em jtaskQuiesce: espera a tarefa sair da fila e terminar de executar.
+ *
+ * A entrada já está inativa, então o worker que a retirar da fila só limpa a marca.
+ */
+void jtaskPoolQuiesce(uint8_t index) {
+  while (jtaskPoolPending[index].load(std::memory_order_acquire)) {
+#ifdef ARDUINO
+    vTaskDelay(1);
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+/**
+ * @brief Laço de um worker: executa a própria fila e rouba quando ela está vazia.
+ */
+void jtaskPoolWorker(uint8_t self) {
+  jtaskReadyQueue_t &q = jtaskPoolQueue[self];
+  while (jtaskPoolRunning.load(std::memory_order_acquire)) {
+    uint8_t index;
+    if (!q.popFront(index) && !jtaskPoolSteal(self, index)) {
+      q.idle.store(true);
+      std::unique_lock<std::mutex> lock(q.mtx);
+      q.cv.wait_for(lock, std::chrono::milliseconds(10), [&] {
+        return q.count > 0 || jtaskPoolStealable.load() > 0 || !jtaskPoolRunning.load();
+      });
+      continue;
+    }
+    q.idle.store(false);
+    if (jtaskPoolUnpinned[index])
+      jtaskPoolStealable.fetch_sub(1, std::memory_order_acq_rel);
+    if (jtaskStruct[index].active.load(std::memory_order_acquire)) jtaskRun(index);
+    jtaskPoolPending[index].store(false, std::memory_order_release);
+  }
+  jtaskPoolAlive.fetch_sub(1);
+}
+
+#ifdef ARDUINO
+void jtaskPoolTask(void *arg) {
+  jtaskPoolWorker((uint8_t)(uintptr_t)arg);
+  vTaskDelete(NULL);
+}
+#endif
+
+/**
+ * @brief Inicia os workers e passa jtaskLoop() para o modo executor.
+ * @return false se o executor já estiver ativo ou um worker não puder ser criado.
+ */
+bool jtaskPoolBegin() {
+  if (jtaskPoolRunning.exchange(true)) return false;
+  if (!jtaskPoolReady) jtaskInitPool();
+  // Alocação única: as filas e as marcas acompanham a capacidade do pool de tarefas.
+  if (!jtaskPoolPending) {
+    jtaskPoolPending = new (std::nothrow) std::atomic<bool>[jtaskCapacity];
+    jtaskPoolUnpinned = new (std::nothrow) bool[jtaskCapacity];
+    for (uint8_t c = 0; c < JTASK_POOL_CORES; c++)
+      jtaskPoolQueue[c].items = new (std::nothrow) uint8_t[jtaskCapacity];
+  }
+  for (uint8_t c = 0; c < JTASK_POOL_CORES; c++) {
+    if (!jtaskPoolPending || !jtaskPoolUnpinned || !jtaskPoolQueue[c].items) {
+      jtaskPoolRunning.store(false);
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < jtaskCapacity; i++) jtaskPoolPending[i].store(false);
+  jtaskPoolStealable.store(0);
+  for (uint8_t c = 0; c < JTASK_POOL_CORES; c++) {
+    jtaskPoolAlive.fetch_add(1);
+#ifdef ARDUINO
+    char name[12];
+    snprintf(name, sizeof(name), "jtask_w%u", c);
+    if (xTaskCreatePinnedToCore(jtaskPoolTask, name, JTASK_POOL_STACK, (void *)(uintptr_t)c,
+                                JTASK_POOL_PRIORITY, nullptr, c % portNUM_PROCESSORS) != pdPASS) {
+      jtaskPoolAlive.fetch_sub(1);
+      jtaskPoolRunning.store(false);
+      return false;
+    }
+#else
+    jtaskPoolThreads[c] = std::thread(jtaskPoolWorker, c);
+#endif
+  }
+  jtaskQuiesce = jtaskPoolQuiesce;
+  jtaskDispatch = jtaskPoolDispatch;
+  return true;
+}
+
+/**
+ * @brief Para os workers e volta jtaskLoop() à execução no próprio loop.
+ *
+ * Espera as tarefas em andamento terminarem; tarefas ainda na fila são descartadas.
+ */
+void jtaskPoolEnd() {
+  if (!jtaskPoolRunning.exchange(false)) return;
+  jtaskDispatch = nullptr;
+  jtaskQuiesce = nullptr;
+  for (uint8_t c = 0; c < JTASK_POOL_CORES; c++) jtaskPoolQueue[c].notify();
+#ifdef ARDUINO
+  while (jtaskPoolAlive.load() > 0) vTaskDelay(1);
+#else
+  for (uint8_t c = 0; c < JTASK_POOL_CORES; c++)
+    if (jtaskPoolThreads[c].joinable()) jtaskPoolThreads[c].join();
+#endif
+  for (uint8_t c = 0; c < JTASK_POOL_CORES; c++) {
+    std::lock_guard<std::mutex> lock(jtaskPoolQueue[c].mtx);
+    jtaskPoolQueue[c].head = 0;
+    jtaskPoolQueue[c].count = 0;
+  }
+  for (uint8_t i = 0; i < jtaskCapacity; i++) jtaskPoolPending[i].store(false);
+  jtaskPoolStealable.store(0);
+}
+
+#endif
@@ -0,0 +1,359 @@
+#ifndef __TIMERWHEEL_H
+#define __TIMERWHEEL_H
+
+/**
+ * @file timerWheel.h
+ * @brief Serviço de temporizadores centralizado (roda de tempo hierárquica).
+ *
+ * Em vez de cada AsyncDelay_c consultar millis() a cada loop, os WheelTimer_c ficam
+ * registrados num TimerWheel_c, que avança uma vez por passagem. A roda tem
+ * TIMERWHEEL_LEVELS níveis de 64 posições: o nível 0 guarda o que vence nos próximos
+ * 64 ticks, o nível 1 nos próximos 64², e assim por diante; quando o nível 0 completa uma
+ * volta, a posição correspondente do nível acima é redistribuída para baixo.
+ *
+ * Iniciar e cancelar são O(1) (listas duplamente encadeadas intrusivas), e update() usa
+ * mapas de ocupação para pular direto às posições com temporizadores, então o custo por
+ * passagem cresce com o número de temporizadores que vencem, não com o número que existe.
+ *
+ * WheelTimer_c tem a mesma interface de AsyncDelay_c (restart, isExpired, repeat), e
+ * isExpired() só lê uma marca feita pela roda. Também aceita callback, única ou periódica.
+ * O relógio da roda pode ser injetado (advance()) para testes no host.
+ *
+ * Uso:
+ *   TimerWheel_c timers;
+ *   WheelTimer_c pisca(timers), leitura(timers);
+ *   pisca.start(500, [](void *) { toggle(); }, nullptr, true);
+ *   leitura.restart(100);
+ *   loop() {
+ *     timers.update();
+ *     if (leitura.isExpired()) ler();
+ *   }
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <chrono>
+#endif
+
+#ifndef TIMERWHEEL_LEVELS
+/**
+ * @brief Número de níveis da roda (alcance de 64^níveis ticks; 4 níveis = 16,7 milhões).
+ */
+#define TIMERWHEEL_LEVELS 4
+#endif
+
+#define TIMERWHEEL_BITS 6
+#define TIMERWHEEL_SLOTS (1u << TIMERWHEEL_BITS)
+#define TIMERWHEEL_MASK (TIMERWHEEL_SLOTS - 1)
+#define TIMERWHEEL_RANGE (1u << (TIMERWHEEL_LEVELS * TIMERWHEEL_BITS))
+
+static_assert(TIMERWHEEL_LEVELS >= 1 && TIMERWHEEL_LEVELS <= 5, "TIMERWHEEL_LEVELS deve estar entre 1 e 5");
+
+class TimerWheel_c;
+
+/**
+ * @class WheelTimer_c
+ * @brief Temporizador registrado num TimerWheel_c (intervalos em ticks da roda).
+ */
+class WheelTimer_c {
+public:
+  /**
+   * @brief Callback chamada quando o temporizador vence.
+   */
+  typedef void (*CallbackFunc)(void *ctx);
+
+  explicit WheelTimer_c(TimerWheel_c &wheel) : _wheel(&wheel) {}
+  ~WheelTimer_c() { cancel(); }
+  WheelTimer_c(const WheelTimer_c &) = delete;
+  WheelTimer_c &operator=(const WheelTimer_c &) = delete;
+
+  /**
+   * @brief Inicia (ou reinicia) o temporizador.
+   * @param interval Intervalo em ticks (ms com o tick padrão); 0 vence no próximo tick.
+   * @param callback Função chamada ao vencer (ou nullptr para usar só isExpired()).
+   * @param ctx Contexto repassado à callback.
+   * @param periodic true para repetir a cada interval, sem deriva.
+   */
+  void start(uint32_t interval, CallbackFunc callback = nullptr, void *ctx = nullptr, bool periodic = false);
+
+  /**
+   * @brief Como AsyncDelay_c::restart(): temporizador periódico sem callback.
+   */
+  void restart(uint32_t interval) { start(interval, _callback, _ctx, true); }
+
+  /**
+   * @brief Como AsyncDelay_c::isExpired(): true uma vez para cada vencimento desde a última consulta.
+   */
+  bool isExpired() {
+    if (!_expired) return false;
+    _expired = false;
+    return true;
+  }
+
+  /**
+   * @brief Como AsyncDelay_c::repeat(): agenda mais um intervalo a partir do último vencimento.
+   *
+   * Útil para temporizadores de disparo único; os periódicos já são reagendados pela roda.
+   */
+  void repeat();
+
+  /**
+   * @brief Remove o temporizador da roda (não faz nada se não estiver ativo).
+   */
+  void cancel();
+
+  /**
+   * @brief Indica se o temporizador está na roda.
+   */
+  bool active() const { return _pprev != nullptr; }
+
+  /**
+   * @brief Tick absoluto do próximo vencimento.
+   */
+  uint32_t expires() const { return _expires; }
+
+private:
+  friend class TimerWheel_c;
+
+  TimerWheel_c *_wheel;
+  WheelTimer_c *_next = nullptr;
+  WheelTimer_c **_pprev = nullptr; ///< Aponta para o ponteiro que aponta para este nó.
+  uint32_t _expires = 0;
+  uint32_t _interval = 0;
+  CallbackFunc _callback = nullptr;
+  void *_ctx = nullptr;
+  uint8_t _level = 0;
+  uint8_t _slot = 0;
+  bool _periodic = false;
+  bool _expired = false;
+};
+
+/**
+ * @class TimerWheel_c
+ * @brief Roda de tempo hierárquica.
+ */
+class TimerWheel_c {
+public:
+  /**
+   * @brief Construtor.
+   * @param tickMs Duração de um tick em milissegundos.
+   */
+  explicit TimerWheel_c(uint32_t tickMs = 1) : _tickMs(tickMs ? tickMs : 1) {
+    _last = clockMs();
+  }
+
+  /**
+   * @brief Avança a roda até o instante atual (millis() no Arduino).
+   * @return Número de temporizadores que venceram.
+   */
+  uint32_t update() {
+    uint32_t now = clockMs();
+    uint32_t ticks = (now - _last) / _tickMs;
+    if (ticks == 0) return 0;
+    _last += ticks * _tickMs;
+    return advance(_now + ticks);
+  }
+
+  /**
+   * @brief Avança a roda até o tick target, disparando os temporizadores vencidos.
+   * @return Número de temporizadores que venceram.
+   */
+  uint32_t advance(uint32_t target) {
+    uint32_t fired = 0;
+    while (_now != target) {
+      if (_count == 0) { // nada registrado: salta direto
+        _now = target;
+        break;
+      }
+      // Próximo tick que tem trabalho: posição ocupada no nível 0 ou fim da volta.
+      uint32_t pos = _now & TIMERWHEEL_MASK;
+      uint64_t occ = (pos == TIMERWHEEL_MASK) ? 0 : _occupied[0] & (~0ULL << (pos + 1));
+      uint32_t next = (_now & ~TIMERWHEEL_MASK) + (occ ? __builtin_ctzll(occ) : TIMERWHEEL_SLOTS);
+      if ((int32_t)(next - target) > 0) {
+        _now = target;
+        break;
+      }
+      _now = next;
+      if ((_now & TIMERWHEEL_MASK) == 0) cascade();
+      fired += expire(_now & TIMERWHEEL_MASK);
+    }
+    return fired;
+  }
+
+  /**
+   * @brief Ticks até o próximo vencimento (0xFFFFFFFF se não houver temporizadores).
+   */
+  uint32_t nextExpiry() const {
+    // Um temporizador ainda num nível superior (antes de descer) pode vencer antes dos do
+    // nível 0, então o mínimo é tomado na primeira posição ocupada de cada nível.
+    uint32_t best = 0xFFFFFFFF;
+    for (uint8_t level = 0; level < TIMERWHEEL_LEVELS; level++) {
+      if (!_occupied[level]) continue;
+      uint32_t cur = (_now >> (level * TIMERWHEEL_BITS)) & TIMERWHEEL_MASK;
+      for (uint32_t k = 1; k <= TIMERWHEEL_SLOTS; k++) {
+        uint32_t slot = (cur + k) & TIMERWHEEL_MASK;
+        if (!((_occupied[level] >> slot) & 1)) continue;
+        for (WheelTimer_c *t = _slots[level][slot]; t; t = t->_next)
+          if (t->_expires - _now < best) best = t->_expires - _now;
+        break;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Tick atual da roda.
+   */
+  uint32_t now() const { return _now; }
+
+  /**
+   * @brief Número de temporizadores ativos.
+   */
+  uint32_t count() const { return _count; }
+
+  /**
+   * @brief Duração do tick em milissegundos.
+   */
+  uint32_t tickMs() const { return _tickMs; }
+
+private:
+  friend class WheelTimer_c;
+
+  static uint32_t clockMs() {
+#ifdef ARDUINO
+    return millis();
+#else
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  /**
+   * @brief Coloca o temporizador na posição correspondente ao seu vencimento.
+   */
+  void insert(WheelTimer_c *t, bool cascading = false) {
+    uint32_t delta = t->_expires - _now;
+    if ((delta == 0 && !cascading) || delta > 0x80000000u) { // já venceu: dispara no próximo tick
+      t->_expires = _now + 1;
+      delta = 1;
+    }
+    uint8_t level = 0;
+    while (level + 1 < TIMERWHEEL_LEVELS && delta >= (1u << ((level + 1) * TIMERWHEEL_BITS))) level++;
+    uint32_t at = t->_expires;
+    if (delta >= TIMERWHEEL_RANGE) at = _now + TIMERWHEEL_RANGE - 1; // além do alcance: reavaliado ao descer
+    uint8_t slot = (at >> (level * TIMERWHEEL_BITS)) & TIMERWHEEL_MASK;
+    link(t, &_slots[level][slot]);
+    t->_level = level;
+    t->_slot = slot;
+    _occupied[level] |= 1ULL << slot;
+  }
+
+  static void link(WheelTimer_c *t, WheelTimer_c **head) {
+    t->_next = *head;
+    if (*head) (*head)->_pprev = &t->_next;
+    *head = t;
+    t->_pprev = head;
+  }
+
+  void unlink(WheelTimer_c *t) {
+    *t->_pprev = t->_next;
+    if (t->_next) t->_next->_pprev = t->_pprev;
+    if (t->_level < TIMERWHEEL_LEVELS && !_slots[t->_level][t->_slot])
+      _occupied[t->_level] &= ~(1ULL << t->_slot);
+    t->_next = nullptr;
+    t->_pprev = nullptr;
+  }
+
+  /**
+   * @brief Move uma posição inteira para uma lista avulsa (fora da roda).
+   */
+  void detachSlot(uint8_t level, uint8_t slot, WheelTimer_c *&list) {
+    list = _slots[level][slot];
+    _slots[level][slot] = nullptr;
+    _occupied[level] &= ~(1ULL << slot);
+    if (list) list->_pprev = &list;
+    for (WheelTimer_c *t = list; t; t = t->_next) t->_level = 0xFF; // lista avulsa
+  }
+
+  /**
+   * @brief Redistribui para baixo as posições dos níveis superiores que começam agora.
+   */
+  void cascade() {
+    for (uint8_t level = 1; level < TIMERWHEEL_LEVELS; level++) {
+      uint8_t slot = (_now >> (level * TIMERWHEEL_BITS)) & TIMERWHEEL_MASK;
+      WheelTimer_c *list;
+      detachSlot(level, slot, list);
+      while (list) {
+        WheelTimer_c *t = list;
+        unlink(t);
+        insert(t, true); // os que vencem agora caem na posição atual, disparada em seguida
+      }
+      if (slot != 0) break;
+    }
+  }
+
+  /**
+   * @brief Dispara os temporizadores da posição slot do nível 0.
+   */
+  uint32_t expire(uint8_t slot) {
+    WheelTimer_c *list;
+    detachSlot(0, slot, list);
+    uint32_t fired = 0;
+    while (list) {
+      WheelTimer_c *t = list;
+      unlink(t);
+      if (t->_expires != _now) { // guardado além do alcance: ainda não é a hora
+        insert(t);
+        continue;
+      }
+      _count--;
+      t->_expired = true;
+      fired++;
+      if (t->_periodic) {
+        t->_expires += t->_interval ? t->_interval : 1; // sem deriva: a partir do vencimento nominal
+        insert(t);
+        _count++;
+      }
+      // A callback pode cancelar ou reiniciar qualquer temporizador, inclusive os da lista avulsa.
+      if (t->_callback) t->_callback(t->_ctx);
+    }
+    return fired;
+  }
+
+  WheelTimer_c *_slots[TIMERWHEEL_LEVELS][TIMERWHEEL_SLOTS] = {};
+  uint64_t _occupied[TIMERWHEEL_LEVELS] = {};
+  uint32_t _now = 0;
+  uint32_t _last;
+  uint32_t _tickMs;
+  uint32_t _count = 0;
+};
+
+inline void WheelTimer_c::start(uint32_t interval, CallbackFunc callback, void *ctx, bool periodic) {
+  cancel();
+  _interval = interval;
+  _callback = callback;
+  _ctx = ctx;
+  _periodic = periodic;
+  _expired = false;
+  _expires = _wheel->_now + (interval ? interval : 1);
+  _wheel->insert(this);
+  _wheel->_count++;
+}
+
+inline void WheelTimer_c::repeat() {
+  uint32_t next = _expires + (_interval ? _interval : 1);
+  cancel();
+  _expires = next;
+  _wheel->insert(this);
+  _wheel->_count++;
+}
+
+inline void WheelTimer_c::cancel() {
+  if (!_pprev) return;
+  _wheel->unlink(this);
+  _wheel->_count--;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file bench_display.cpp
+ * @brief Medida de Display_c sobre o FbMemory_c: tempo de renderização e bytes por quadro.
+ *
+ * O relógio da rolagem é simulado (update(t) a cada 40 ms), então os quadros e os bytes são
+ * determinísticos; só o tempo de renderização depende da máquina.
+ *
+ * Os cenários "(quadro inteiro)" são a referência: o laço do Display_c original, que a cada
+ * quadro com texto rolando (ou alterado) apagava a tela, rasterizava as três linhas, avançava
+ * a rolagem em 1 pixel e enviava os FB_WIDTH * FB_PAGES bytes. O gráfico, que não existia, é
+ * redesenhado inteiro. O envio passa pelo mesmo FbMemory_c, então bytes e janelas são
+ * medidos pelos mesmos contadores.
+ */
+
+#include "services/display_c.h"
+#include "check.h"
+#include <chrono>
+
+#define FRAMES 500
+#define FRAME_US 40000UL
+
+typedef std::chrono::steady_clock clock_t_;
+
+/**
+ * @brief Imprime uma linha da tabela.
+ */
+static void report(const char *name, uint32_t frames, clock_t_::duration total, clock_t_::duration worst,
+                   uint32_t bytes, uint32_t windows) {
+  double ns = std::chrono::duration<double, std::nano>(total).count() / FRAMES;
+  double worstNs = std::chrono::duration<double, std::nano>(worst).count();
+  printf("%-30s %8u %10.0f %10.0f %10.1f %10.2f\n", name, frames, ns, worstNs, (double)bytes / FRAMES,
+         (double)windows / FRAMES);
+}
+
+/**
+ * @brief Roda FRAMES quadros e imprime uma linha da tabela.
+ * @param name Nome do cenário.
+ * @param line1 Texto da linha 1 (longo: rola).
+ * @param line3 Texto da linha 3.
+ * @param trend Gráfico na área da linha 3 (ou nullptr).
+ */
+static void run(const char *name, const char *line1, const char *line3, FbTrend_c *trend) {
+  FbMemory_c mem;
+  Display_c disp;
+  disp.setBackend(&mem);
+  CHECK(startDisplay(&disp, 0, 0));
+  disp.setText(1, line1);
+  disp.setText(3, line3);
+  disp.setTrend(trend);
+  disp.update(0);
+  disp.resetStats();
+    clock_t_::duration total{}, worst{};
+  int32_t v = 0;
+  for (unsigned long i = 1; i <= FRAMES; i++) {
+    if (trend) {
+      v += (int32_t)(i * 7919 % 61) - 30;
+      trend->push(v);
+    }
+    auto t0 = clock_t_::now();
+    disp.update(i * FRAME_US);
+    auto dt = clock_t_::now() - t0;
+    total += dt;
+    if (dt > worst) worst = dt;
+  }
+  displayStats_t s = disp.stats();
+  // O que foi enviado deve ser exatamente o que foi desenhado.
+  CHECK(memcmp(mem.ram(), mem.buffer(), FB_WIDTH * FB_PAGES) == 0);
+  report(name, s.frames, total, worst, s.bytes, s.windows);
+}
+
+/**
+ * @struct fullFrame_t
+ * @brief Laço do Display_c original sobre um FbBackend_c: tela inteira a cada quadro.
+ */
+struct fullFrame_t {
+  FbBackend_c *target;
+  FbTrend_c *trend;
+  char text[3][20] = {};
+  uint8_t size[3] = {};
+  int16_t x[3] = {12, 12, 12};
+  int16_t minX[3] = {};
+  bool scrollLeft[3] = {};
+  bool changed = true;
+  uint32_t frames = 0;
+
+  void setText(uint8_t line, const char *txt) {
+    strncpy(text[line - 1], txt, sizeof(text[0]) - 1);
+    size[line - 1] = strlen(text[line - 1]);
+    minX[line - 1] = -12 * (size[line - 1] - 9);
+    changed = true;
+  }
+
+  void update() {
+    if (!(size[0] > 10 || size[1] > 10 || size[2] > 10 || changed || trend)) return;
+    changed = false;
+    uint8_t *fb = target->buffer();
+    memset(fb, 0, FB_WIDTH * FB_PAGES);
+    for (uint8_t i = 0; i < 3; i++) {
+      uint8_t rows[(FB_WIDTH + 7) / 8 * 16];
+      if (fbTextRows(rows, FB_WIDTH, 16, size[i] > 10 ? x[i] : 0, text[i], 2))
+        fbBlitRows(fb, rows, FB_WIDTH, 16, 0, i * 20);
+      if (size[i] <= 10) continue;
+      x[i] += scrollLeft[i] ? 1 : -1;
+      if (x[i] < minX[i]) scrollLeft[i] = true;
+      if (x[i] > 12) scrollLeft[i] = false;
+    }
+    if (trend) {
+      fbDirty_t dirty;
+      trend->invalidate();
+      trend->draw(fb, dirty);
+    }
+    target->write(0, FB_PAGES - 1, 0, FB_WIDTH - 1, fb);
+    frames++;
+  }
+};
+
+/**
+ * @brief Mesmo cenário de run() com o laço original.
+ */
+static void runFull(const char *name, const char *line1, const char *line3, FbTrend_c *trend) {
+  FbMemory_c mem;
+  CHECK(mem.begin());
+  fullFrame_t disp{&mem, trend};
+  disp.setText(1, line1);
+  disp.setText(3, line3);
+  disp.update();
+  mem.resetCounters();
+  disp.frames = 0;
+  clock_t_::duration total{}, worst{};
+  int32_t v = 0;
+  for (unsigned long i = 1; i <= FRAMES; i++) {
+    if (trend) {
+      v += (int32_t)(i * 7919 % 61) - 30;
+      trend->push(v);
+    }
+    auto t0 = clock_t_::now();
+    disp.update();
+    auto dt = clock_t_::now() - t0;
+    total += dt;
+    if (dt > worst) worst = dt;
+  }
+  CHECK(memcmp(mem.ram(), mem.buffer(), FB_WIDTH * FB_PAGES) == 0);
+  report(name, disp.frames, total, worst, mem.bytes(), mem.windows());
+}
+
+int main() {
+  printf("%d quadros de %lu us; tela inteira = %d bytes/quadro\n", FRAMES, FRAME_US, FB_WIDTH * FB_PAGES);
+  printf("%-30s %8s %10s %10s %10s %10s\n", "cenario", "quadros", "ns/upd", "pior ns", "bytes/q", "janelas/q");
+  run("estatico", "IIKit", "curta", nullptr);
+  run("rolagem", "linha longa que rola", "curta", nullptr);
+  FbTrend_c trend(0, 40, 128, 24);
+  run("tendencia", "IIKit", "", &trend);
+  FbTrend_c trend2(0, 40, 128, 24);
+  run("rolagem+tendencia", "linha longa que rola", "", &trend2);
+  runFull("estatico (quadro inteiro)", "IIKit", "curta", nullptr);
+  runFull("rolagem (quadro inteiro)", "linha longa que rola", "curta", nullptr);
+  FbTrend_c trend3(0, 40, 128, 24);
+  runFull("tendencia (quadro inteiro)", "IIKit", "", &trend3);
+  FbTrend_c trend4(0, 40, 128, 24);
+  runFull("rolagem+tend. (quadro inteiro)", "linha longa que rola", "", &trend4);
+  return 0;
+}
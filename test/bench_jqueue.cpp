@@ -0,0 +1,182 @@
+/**
+ * @file bench_jqueue.cpp
+ * @brief Vazão de JQueue (send/receive e sendN/receiveN) contra a fila jQueue_t original.
+ *
+ * A referência é a jQueue_t de antes do JQueue: vetor de MAXLENGTHJQUEUE ponteiros com
+ * head, tail e um contador compartilhado, atualizados por ambos os lados. Sem trava ela só
+ * é correta numa thread, então entre threads é medida com um mutex em cada operação, o papel
+ * que a seção crítica (portENTER_CRITICAL) teria no ESP32. A jQueue_t atual tem capacidade
+ * jQueueCeilPow2(MAXLENGTHJQUEUE): 8 com o padrão 5, então a referência também usa 8.
+ *
+ * Com um único núcleo livre a coluna de duas threads mede sobretudo trocas de contexto.
+ */
+
+#include "util/jqueue.h"
+#include "check.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#define ITEMS 1000000u
+#define BATCH 4u
+#define CAPACITY jQueueCeilPow2(MAXLENGTHJQUEUE)
+
+/**
+ * @struct oldQueue_t
+ * @brief Fila original (contador compartilhado), com trava opcional.
+ */
+struct oldQueue_t {
+  void *buffer[CAPACITY];
+  uint8_t head = 0;
+  uint8_t tail = 0;
+  uint8_t count = 0;
+  std::mutex mtx;
+  bool locked = false;
+
+  bool send(void *item) {
+    if (locked) mtx.lock();
+    bool ok = count != CAPACITY;
+    if (ok) {
+      buffer[tail] = item;
+      tail = (tail + 1) % CAPACITY;
+      count++;
+    }
+    if (locked) mtx.unlock();
+    return ok;
+  }
+
+  bool receive(void **item) {
+    if (locked) mtx.lock();
+    bool ok = count != 0;
+    if (ok) {
+      *item = buffer[head];
+      head = (head + 1) % CAPACITY;
+      count--;
+    }
+    if (locked) mtx.unlock();
+    return ok;
+  }
+};
+
+typedef std::chrono::steady_clock clock_t_;
+
+static double nsPerItem(clock_t_::time_point t0) {
+  return std::chrono::duration<double, std::nano>(clock_t_::now() - t0).count() / ITEMS;
+}
+
+/**
+ * @brief Uma thread: envia um lote e o recebe, repetidamente. Duas threads: produtor e
+ * consumidor separados, cedendo a CPU quando não há progresso.
+ * @param threaded false para filas que não suportam duas threads (só a primeira coluna).
+ */
+template <typename Send, typename Receive>
+static void measure(const char *name, Send send, Receive receive, bool threaded = true) {
+  uintptr_t sum = 0;
+  auto t0 = clock_t_::now();
+  for (uint32_t i = 0; i < ITEMS;) {
+    uint32_t n = send(i + 1, ITEMS - i);
+    i += n;
+    for (uint32_t got = 0; got < n;) got += receive(sum, n - got);
+  }
+  double single = nsPerItem(t0);
+  CHECK(sum == (uintptr_t)ITEMS * (ITEMS + 1) / 2);
+  if (!threaded) {
+    printf("%-26s %12.1f %12s\n", name, single, "-");
+    return;
+  }
+
+  sum = 0;
+  t0 = clock_t_::now();
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < ITEMS;) {
+      uint32_t n = send(i + 1, ITEMS - i);
+      if (!n) std::this_thread::yield();
+      i += n;
+    }
+  });
+  for (uint32_t got = 0; got < ITEMS;) {
+    uint32_t n = receive(sum, ITEMS - got);
+    if (!n) std::this_thread::yield();
+    got += n;
+  }
+  producer.join();
+  double threads = nsPerItem(t0);
+  CHECK(sum == (uintptr_t)ITEMS * (ITEMS + 1) / 2);
+  printf("%-26s %12.1f %12.1f\n", name, single, threads);
+}
+
+int main() {
+  printf("%u itens, capacidade %u, lotes de %u\n", ITEMS, (unsigned)CAPACITY, BATCH);
+  printf("%-26s %12s %12s\n", "fila", "ns/item 1T", "ns/item 2T");
+
+  // Sem trava a fila original só serve numa thread.
+  oldQueue_t bare;
+  measure(
+      "jQueue_t original",
+      [&](uint32_t v, uint32_t) -> uint32_t { return bare.send((void *)(uintptr_t)v); },
+      [&](uintptr_t &sum, uint32_t) -> uint32_t {
+        void *v;
+        if (!bare.receive(&v)) return 0;
+        sum += (uintptr_t)v;
+        return 1;
+      },
+      false);
+
+  oldQueue_t old;
+  old.locked = true;
+  measure(
+      "jQueue_t original + trava",
+      [&](uint32_t v, uint32_t) -> uint32_t { return old.send((void *)(uintptr_t)v); },
+      [&](uintptr_t &sum, uint32_t) -> uint32_t {
+        void *v;
+        if (!old.receive(&v)) return 0;
+        sum += (uintptr_t)v;
+        return 1;
+      });
+
+  jQueue_t legacy;
+  jQueueInit(&legacy);
+  measure(
+      "jQueue_t (JQueue)",
+      [&](uint32_t v, uint32_t) -> uint32_t { return jQueueSendFromISR(&legacy, (void *)(uintptr_t)v); },
+      [&](uintptr_t &sum, uint32_t) -> uint32_t {
+        void *v;
+        if (!jQueueReceive(&legacy, &v)) return 0;
+        sum += (uintptr_t)v;
+        return 1;
+      });
+
+  jQueue_t batched;
+  jQueueInit(&batched);
+  measure(
+      "jQueue_t sendN/receiveN",
+      [&](uint32_t v, uint32_t left) -> uint32_t {
+        void *items[BATCH];
+        uint32_t n = left < BATCH ? left : BATCH;
+        for (uint32_t k = 0; k < n; k++) items[k] = (void *)(uintptr_t)(v + k);
+        return jQueueSendNFromISR(&batched, items, n);
+      },
+      [&](uintptr_t &sum, uint32_t left) -> uint32_t {
+        void *items[BATCH];
+        uint32_t n = jQueueReceiveN(&batched, items, left < BATCH ? left : BATCH);
+        for (uint32_t k = 0; k < n; k++) sum += (uintptr_t)items[k];
+        return n;
+      });
+
+  static JQueue<uint32_t, 256> wide;
+  measure(
+      "JQueue<uint32_t,256> N=32",
+      [&](uint32_t v, uint32_t left) -> uint32_t {
+        uint32_t items[32];
+        uint32_t n = left < 32 ? left : 32;
+        for (uint32_t k = 0; k < n; k++) items[k] = v + k;
+        return wide.sendN(items, n);
+      },
+      [&](uintptr_t &sum, uint32_t left) -> uint32_t {
+        uint32_t items[32];
+        uint32_t n = wide.receiveN(items, left < 32 ? left : 32);
+        for (uint32_t k = 0; k < n; k++) sum += items[k];
+        return n;
+      });
+  return 0;
+}
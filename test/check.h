@@ -0,0 +1,20 @@
+#ifndef __CHECK_H
+#define __CHECK_H
+
+/**
+ * @file check.h
+ * @brief Verificação mínima para os testes de host (vale também com NDEBUG).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(cond)                                                      \
+  do {                                                                   \
+    if (!(cond)) {                                                       \
+      fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+      exit(1);                                                           \
+    }                                                                    \
+  } while (0)
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file test_clocksync.cpp
+ * @brief ClockSync_c contra um assinante simulado (respond()) com offset e deriva conhecidos.
+ */
+
+#include "util/clockSync.h"
+#include "check.h"
+#include <math.h>
+
+#define OFFSET_US 1500000.0 ///< host - local no instante local 0.
+#define DRIFT_PPM 50.0      ///< O relógio do host anda 50 ppm mais rápido.
+
+/**
+ * @brief Relógio do host para um instante local.
+ */
+static int64_t host(double local) { return (int64_t)llround(OFFSET_US + local * (1.0 + DRIFT_PPM * 1e-6)); }
+
+static uint32_t rng = 1;
+static uint32_t next() {
+  rng = rng * 1664525u + 1013904223u;
+  return rng >> 8;
+}
+
+/**
+ * @brief Uma troca SYNC/SYNCR iniciada no instante local t1.
+ * @param up Atraso de ida (µs).
+ * @param down Atraso de volta (µs).
+ * @return Resultado de handleResponse().
+ */
+static bool exchange(ClockSync_c &sync, int64_t t1, int64_t up, int64_t down) {
+  char req[48], resp[96];
+  CHECK(sync.makeRequest(req, sizeof(req), t1) > 0);
+  int64_t t2 = host((double)(t1 + up));
+  int64_t t3 = host((double)(t1 + up + 40));  // 40 µs para responder
+  CHECK(ClockSync_c::respond(req, t2, t3, resp, sizeof(resp)) > 0);
+  return sync.handleResponse(resp, t1 + up + 40 + down);
+}
+
+/**
+ * @brief Convergência: offset e deriva estimados com atraso simétrico e pouco jitter, com
+ * trocas assimétricas (atraso alto numa direção) rejeitadas pelo filtro de atraso.
+ */
+static void testConverge() {
+  ClockSync_c sync;
+  CHECK(!sync.isSynced() && sync.toHost(12345) == 12345);
+  int64_t t = 10000000;
+  int accepted = 0, rejected = 0;
+  for (int i = 0; i < 60; i++, t += 1000000) {
+    int64_t up = 300 + next() % 20, down = 300 + next() % 20;
+    if (i % 7 == 3) {
+      up += 20000;  // fila na ida: atraso alto e offset deslocado em ~10 ms
+      CHECK(!exchange(sync, t, up, down));
+      rejected++;
+      continue;
+    }
+    CHECK(exchange(sync, t, up, down));
+    accepted++;
+    CHECK(sync.lastDelay() == up + down);
+    if (i < 10) continue;
+    int64_t probe = t + 500000;
+    double err = (double)(sync.toHost(probe) - host((double)probe));
+    CHECK(fabs(err) < 40.0);
+    CHECK(fabs(sync.driftPpm() - DRIFT_PPM) < 10.0);
+  }
+  CHECK(accepted > 40 && rejected > 5);
+  CHECK(sync.isSynced());
+  // Extrapolação de 5 s além da última troca: o erro cresce só com o erro da deriva.
+  double err = (double)(sync.toHost(t + 5000000) - host((double)(t + 5000000)));
+  CHECK(fabs(err) < 40.0 + 10.0 * 5.0);
+  printf("deriva=%.2f ppm erro=%.1f us\n", sync.driftPpm(), err);
+}
+
+/**
+ * @brief Respostas repetidas, atrasadas ou malformadas não viram amostras.
+ */
+static void testReject() {
+  ClockSync_c sync;
+  char req[48], old[96], resp[96];
+  CHECK(sync.makeRequest(req, sizeof(req), 1000) > 0);
+  CHECK(ClockSync_c::respond(req, host(1200), host(1240), old, sizeof(old)) > 0);
+  CHECK(sync.makeRequest(req, sizeof(req), 2000000) > 0);
+  CHECK(!sync.handleResponse(old, 1500));  // resposta da requisição anterior
+  CHECK(ClockSync_c::respond(req, host(2000200), host(2000240), resp, sizeof(resp)) > 0);
+  CHECK(sync.handleResponse(resp, 2000440));
+  CHECK(!sync.handleResponse(resp, 2000450));  // duplicada
+  CHECK(sync.isSynced());
+  CHECK(llabs(sync.offset(2000220) - (host(2000220) - 2000220)) <= 1);
+
+  CHECK(sync.makeRequest(req, sizeof(req), 3000000) > 0);
+  CHECK(!sync.handleResponse("SYNCR:3:3000000", 3000400));
+  CHECK(!sync.handleResponse("SYNC:3:3000000:1:2", 3000400));
+  CHECK(!sync.handleResponse("SYNCR:x", 3000400));
+  // t4 antes de t1: atraso negativo.
+  CHECK(ClockSync_c::respond(req, host(3000200), host(3000240), resp, sizeof(resp)) > 0);
+  CHECK(!sync.handleResponse(resp, 2999000));
+
+  CHECK(ClockSync_c::respond("SYNCR:1:2:3:4", 1, 2, resp, sizeof(resp)) == 0);
+  CHECK(ClockSync_c::respond("SYNC:1", 1, 2, resp, sizeof(resp)) == 0);
+  CHECK(ClockSync_c::respond("SYNC:1:2", 1, 2, resp, 8) == 0);  // não cabe
+  CHECK(sync.makeRequest(req, 8, 1) == 0);
+
+  sync.reset();
+  CHECK(!sync.isSynced() && sync.toHost(42) == 42 && sync.driftPpm() == 0.0);
+}
+
+int main() {
+  testConverge();
+  testReject();
+  puts("ok");
+  return 0;
+}
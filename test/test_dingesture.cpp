@@ -0,0 +1,222 @@
+/**
+ * @file test_dingesture.cpp
+ * @brief DinGesture_c com bordas e instantes roteirizados: cliques, pressão longa, repetições e fila cheia.
+ */
+
+#include "util/dinGesture.h"
+#include "check.h"
+
+#define MS 1000UL
+
+static dinEvent_t got[64];
+
+/**
+ * @brief Esvazia a fila de eventos em got.
+ * @return Número de eventos.
+ */
+static uint32_t drain(DinGesture_c &g) {
+  uint32_t n = 0;
+  while (n < 64) {
+    uint32_t k = g.events.receiveN(got + n, 64 - n);
+    if (!k) break;
+    n += k;
+  }
+  return n;
+}
+
+/**
+ * @brief Compara o evento i com o esperado.
+ */
+static bool is(uint32_t i, dinEventType_t type, unsigned long us, uint8_t input = 0) {
+  return got[i].type == type && got[i].us == us && got[i].input == input;
+}
+
+/**
+ * @brief Chama poll() a cada passo de 1 ms entre from e to (inclusive).
+ */
+static void pollRange(DinGesture_c &g, unsigned long from, unsigned long to, unsigned long step = MS) {
+  for (unsigned long t = from; t <= to; t += step) g.poll(t);
+}
+
+/**
+ * @brief Clique simples: confirmado só quando a janela de duplo clique expira, com o instante da soltura.
+ */
+static void testClick() {
+  DinGesture_c g;
+  g.edge(0, true, 1000 * MS);
+  g.edge(0, false, 1100 * MS);
+  pollRange(g, 1100 * MS, 1400 * MS);  // ainda dentro da janela (300 ms, inclusive)
+  CHECK(drain(g) == 2 && is(0, DIN_PRESS, 1000 * MS) && is(1, DIN_RELEASE, 1100 * MS));
+  g.poll(1400 * MS + 1);
+  CHECK(drain(g) == 1 && is(0, DIN_CLICK, 1100 * MS));
+  pollRange(g, 1401 * MS, 3000 * MS);
+  CHECK(drain(g) == 0);
+}
+
+/**
+ * @brief Duplo clique dentro da janela (no limite exato) e segundo toque atrasado.
+ */
+static void testDoubleAndLate() {
+  DinGesture_c g;
+  g.edge(0, true, 0);
+  g.edge(0, false, 100 * MS);
+  g.poll(200 * MS);
+  g.edge(0, true, 400 * MS);  // exatamente doubleClickUs depois da soltura
+  g.poll(450 * MS);
+  g.edge(0, false, 500 * MS);
+  pollRange(g, 500 * MS, 1500 * MS);
+  CHECK(drain(g) == 5);
+  CHECK(is(0, DIN_PRESS, 0) && is(1, DIN_RELEASE, 100 * MS) && is(2, DIN_PRESS, 400 * MS));
+  CHECK(is(3, DIN_RELEASE, 500 * MS) && is(4, DIN_DOUBLE_CLICK, 500 * MS));
+
+  // Segundo toque 1 µs depois da janela, antes de poll() confirmar o primeiro clique: dois cliques.
+  unsigned long t = 2000 * MS;
+  g.edge(0, true, t);
+  g.edge(0, false, t + 50 * MS);
+  g.edge(0, true, t + 350 * MS + 1);
+  CHECK(drain(g) == 4 && is(2, DIN_CLICK, t + 50 * MS) && is(3, DIN_PRESS, t + 350 * MS + 1));
+  g.edge(0, false, t + 400 * MS);
+  pollRange(g, t + 400 * MS, t + 800 * MS);
+  CHECK(drain(g) == 2 && is(0, DIN_RELEASE, t + 400 * MS) && is(1, DIN_CLICK, t + 400 * MS));
+}
+
+/**
+ * @brief Pressão longa e repetições nos instantes nominais, com poll() a cada 1 ms.
+ */
+static void testLongPressRepeat() {
+  DinGesture_c g;
+  g.edge(0, true, 10 * MS);
+  pollRange(g, 10 * MS, 809 * MS);
+  CHECK(drain(g) == 1);
+  pollRange(g, 810 * MS, 1410 * MS);  // pressão longa em 810, repetições em 960, 1110, 1260, 1410
+  g.edge(0, false, 1420 * MS);
+  pollRange(g, 1420 * MS, 2000 * MS);
+  CHECK(drain(g) == 6);  // sem CLICK após a longa
+  CHECK(is(0, DIN_LONG_PRESS, 810 * MS));
+  for (int k = 0; k < 4; k++) CHECK(is(1 + k, DIN_REPEAT, (960 + 150 * k) * MS));
+  CHECK(is(5, DIN_RELEASE, 1420 * MS));
+}
+
+/**
+ * @brief Loop lento: uma repetição por poll() e as perdidas são puladas, sem deriva de fase.
+ *
+ * Repetições nominais em 960, 1110, 1260, ... Com poll() em 1000 sai a de 960 e a próxima é
+ * 1110; em 1500 (perdidas 1260 e 1410) sai 1110 e a próxima é 1560; em 1560 exato sai 1560.
+ */
+static void testSkippedRepeats() {
+  DinGesture_c g;
+  g.edge(0, true, 10 * MS);
+  g.poll(1000 * MS);  // pressão longa (810) e a repetição de 960 na mesma passagem
+  CHECK(drain(g) == 3 && is(1, DIN_LONG_PRESS, 810 * MS) && is(2, DIN_REPEAT, 960 * MS));
+  g.poll(1109 * MS);
+  CHECK(drain(g) == 0);
+  g.poll(1500 * MS);
+  CHECK(drain(g) == 1 && is(0, DIN_REPEAT, 1110 * MS));
+  g.poll(1559 * MS);
+  CHECK(drain(g) == 0);
+  g.poll(1560 * MS);
+  CHECK(drain(g) == 1 && is(0, DIN_REPEAT, 1560 * MS));
+  g.poll(1560 * MS + 10 * 150 * MS);  // dez períodos exatos depois: uma só, a próxima vem depois
+  CHECK(drain(g) == 1 && is(0, DIN_REPEAT, 1710 * MS));
+  g.poll(3060 * MS + 149 * MS);
+  CHECK(drain(g) == 0);
+  g.poll(3210 * MS);
+  CHECK(drain(g) == 1 && is(0, DIN_REPEAT, 3210 * MS));
+
+  // Sem repetição: só a pressão longa.
+  DinGesture_c once;
+  once.config.repeatUs = 0;
+  once.edge(0, true, 0);
+  pollRange(once, 0, 5000 * MS, 7 * MS);
+  CHECK(drain(once) == 2 && is(1, DIN_LONG_PRESS, 800 * MS));
+}
+
+/**
+ * @brief Clique seguido de pressão longa: o clique sai antes da longa e não há duplo clique.
+ */
+static void testClickThenLong() {
+  DinGesture_c g;
+  g.config.repeatUs = 0;
+  g.edge(0, true, 0);
+  g.edge(0, false, 50 * MS);
+  g.edge(0, true, 200 * MS);  // dentro da janela: seria um duplo clique
+  pollRange(g, 200 * MS, 1100 * MS);
+  g.edge(0, false, 1200 * MS);
+  pollRange(g, 1200 * MS, 2000 * MS);
+  CHECK(drain(g) == 6);
+  CHECK(is(0, DIN_PRESS, 0) && is(1, DIN_RELEASE, 50 * MS) && is(2, DIN_PRESS, 200 * MS));
+  CHECK(is(3, DIN_CLICK, 50 * MS) && is(4, DIN_LONG_PRESS, 1000 * MS) && is(5, DIN_RELEASE, 1200 * MS));
+}
+
+/**
+ * @brief doubleClickUs = 0: clique imediato na soltura, sem duplo clique nem estado pendente.
+ */
+static void testNoDoubleClick() {
+  DinGesture_c g;
+  g.config.doubleClickUs = 0;
+  g.edge(0, true, 0);
+  g.edge(0, false, 10 * MS);
+  g.edge(0, true, 10 * MS);  // mesmo instante da soltura
+  g.edge(0, false, 20 * MS);
+  pollRange(g, 20 * MS, 500 * MS);
+  CHECK(drain(g) == 6);
+  CHECK(is(2, DIN_CLICK, 10 * MS) && is(3, DIN_PRESS, 10 * MS) && is(5, DIN_CLICK, 20 * MS));
+}
+
+/**
+ * @brief Entradas independentes, máscara de pinos com nível ativo baixo e bordas repetidas.
+ */
+static void testFeedMask() {
+  DinGesture_c g;
+  g.config.doubleClickUs = 0;
+  CHECK(g.bind(0, 34, true) && g.bind(1, 2) && !g.bind(DIN_GESTURE_INPUTS, 3) && !g.bind(2, 64));
+  uint64_t idle = 1ULL << 34;  // 34 solto em nível alto, 2 solto em nível baixo
+  g.feedMask(1ULL << 34, 0, 100);  // 34 caiu: pressionado
+  g.feedMask(1ULL << 2, 1ULL << 2, 150);
+  g.feedMask(1ULL << 34, 0, 160);  // borda repetida: ignorada
+  CHECK(g.isPressed(0) && g.isPressed(1));
+  g.feedMask((1ULL << 34) | (1ULL << 2), idle, 200);
+  g.feedMask(1ULL << 5, idle, 300);  // pino não associado
+  CHECK(drain(g) == 6);
+  CHECK(is(0, DIN_PRESS, 100, 0) && is(1, DIN_PRESS, 150, 1));
+  CHECK(is(2, DIN_RELEASE, 200, 0) && is(3, DIN_CLICK, 200, 0) && is(4, DIN_RELEASE, 200, 1) && is(5, DIN_CLICK, 200, 1));
+}
+
+/**
+ * @brief Fila cheia: eventos descartados são contados e a máquina continua consistente.
+ */
+static void testQueueFull() {
+  DinGesture_c g;
+  g.config.doubleClickUs = 0;
+  for (int i = 0; i < 10; i++) {  // 30 eventos numa fila de DIN_GESTURE_QUEUE
+    g.edge(0, true, i * 10 * MS);
+    g.edge(0, false, i * 10 * MS + 5 * MS);
+  }
+  CHECK(g.dropped() == 30 - DIN_GESTURE_QUEUE);
+  CHECK(drain(g) == DIN_GESTURE_QUEUE);
+  for (uint32_t i = 0; i < DIN_GESTURE_QUEUE; i++) CHECK(got[i].type == (i % 3 == 0 ? DIN_PRESS : i % 3 == 1 ? DIN_RELEASE : DIN_CLICK));
+  g.edge(0, true, 1000 * MS);
+  CHECK(drain(g) == 1 && is(0, DIN_PRESS, 1000 * MS) && g.dropped() == 30 - DIN_GESTURE_QUEUE);
+
+  // Pressão longa descartada por fila cheia não é reemitida, mas as repetições continuam.
+  for (uint32_t i = 0; i < 2 * DIN_GESTURE_QUEUE; i++) g.edge(1, (i & 1) == 0, 1000 * MS + i);
+  uint32_t dropped = g.dropped();
+  g.poll(1800 * MS);
+  CHECK(g.dropped() == dropped + 1);
+  CHECK(drain(g) == DIN_GESTURE_QUEUE);
+  g.poll(1950 * MS);
+  CHECK(drain(g) == 1 && is(0, DIN_REPEAT, 1950 * MS));
+}
+
+int main() {
+  testClick();
+  testDoubleAndLate();
+  testLongPressRepeat();
+  testSkippedRepeats();
+  testClickThenLong();
+  testNoDoubleClick();
+  testFeedMask();
+  testQueueFull();
+  puts("ok");
+  return 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file test_display.cpp
+ * @brief Envio parcial do Display_c sobre o FbMemory_c: janelas enviadas e rasterizações por quadro.
+ */
+
+#include "services/display_c.h"
+#include "check.h"
+
+#define FRAME_US 40000UL
+
+/**
+ * @struct window_t
+ * @brief Janela recebida pelo backend.
+ */
+struct window_t {
+  uint8_t p0, p1, x0, x1;
+};
+
+/**
+ * @struct memLog_t
+ * @brief FbMemory_c que também guarda as janelas de cada quadro.
+ */
+struct memLog_t : FbMemory_c {
+  window_t log[64];
+  int n = 0;
+
+protected:
+  void writeRegion(uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) override {
+    if (n < 64) log[n] = window_t{page0, page1, x0, x1};
+    n++;
+    FbMemory_c::writeRegion(page0, page1, x0, x1, fb);
+  }
+};
+
+/**
+ * @brief Rasterizador que conta as chamadas por texto.
+ */
+static char lastText[3][20];
+static int rasterCalls[3];
+static bool countingRaster(uint8_t *rows, uint16_t w, uint8_t h, int16_t x, const char *text, uint8_t size) {
+  for (int i = 0; i < 3; i++)
+    if (!strcmp(text, lastText[i])) rasterCalls[i]++;
+  return fbTextRows(rows, w, h, x, text, size);
+}
+
+/**
+ * @struct probe_t
+ * @brief Display_c com acesso à posição de rolagem.
+ */
+struct probe_t : Display_c {
+  int16_t right(uint8_t i) const {
+    int16_t x = ui8_lineSize[i] > 10 ? i16_lineWidth[i] : 0, w = 6 * ui8_txtSize[i] * ui8_lineSize[i];
+    return x + w < 0 ? 0 : (x + w > FB_WIDTH ? FB_WIDTH : x + w);
+  }
+};
+
+static memLog_t mem;
+static probe_t disp;
+static unsigned long now = 0;
+
+/**
+ * @brief Configura as três linhas e zera contadores, janelas e rasterizações.
+ */
+static void setup(const char *l1, const char *l2, const char *l3, uint8_t size3 = 2) {
+  strcpy(lastText[0], l1);
+  strcpy(lastText[1], l2);
+  strcpy(lastText[2], l3);
+  disp.setText(1, l1);
+  disp.setText(2, l2);
+  disp.setText(3, l3, false, size3);
+  now += FRAME_US;
+  disp.update(now);
+  CHECK(memcmp(mem.ram(), mem.buffer(), FB_WIDTH * FB_PAGES) == 0);
+  mem.resetCounters();
+  mem.n = 0;
+  memset(rasterCalls, 0, sizeof(rasterCalls));
+  disp.resetStats();
+}
+
+/**
+ * @brief Tela parada: nenhum byte, nenhuma janela, nenhum quadro.
+ */
+static void testStatic() {
+  setup("IIKit", "abc", "xyz");
+  for (int i = 0; i < 100; i++) disp.update(now += FRAME_US);
+  CHECK(mem.bytes() == 0 && mem.windows() == 0);
+  CHECK(disp.stats().frames == 0);
+  CHECK(rasterCalls[0] == 0 && rasterCalls[1] == 0 && rasterCalls[2] == 0);
+}
+
+/**
+ * @brief Só a linha 1 rola: cada quadro envia uma janela nas páginas 0..1, das colunas 0 até a
+ * maior extensão (antes ou depois do passo), e nada é rasterizado de novo.
+ */
+static void testScrollOneLine() {
+  setup("linha longa que ro", "abc", "xyz");
+  uint8_t other[FB_WIDTH * FB_PAGES];
+  memcpy(other, mem.ram(), sizeof(other));
+  int16_t before = disp.right(0);
+  uint32_t frames = 0;
+  for (int i = 0; i < 500; i++) {
+    mem.n = 0;
+    disp.update(now += FRAME_US);
+    int16_t after = disp.right(0);
+    int16_t span = before > after ? before : after;
+    if (span) {
+      CHECK(mem.n == 1);
+      CHECK(mem.log[0].p0 == 0 && mem.log[0].p1 == 1);
+      CHECK(mem.log[0].x0 == 0 && mem.log[0].x1 == span - 1);
+      frames++;
+    } else {
+      CHECK(mem.n == 0);
+    }
+    before = after;
+    CHECK(memcmp(mem.ram(), mem.buffer(), FB_WIDTH * FB_PAGES) == 0);
+  }
+  CHECK(frames > 400);  // 40 px/s a 25 quadros/s: um pixel por quadro
+  CHECK(memcmp(mem.ram() + 2 * FB_WIDTH, other + 2 * FB_WIDTH, 6 * FB_WIDTH) == 0);
+  CHECK(mem.bytes() <= frames * 2 * FB_WIDTH);
+  CHECK(rasterCalls[0] == 0 && rasterCalls[1] == 0 && rasterCalls[2] == 0);
+}
+
+/**
+ * @brief Uma linha que não cabe numa faixa é rasterizada a cada quadro; as demais, nunca.
+ * Trocar o texto de uma linha parada a rasteriza uma única vez.
+ */
+static void testRasterizeOnlyChanged() {
+  setup("linha longa que ro", "abc", "tamanho tres rola", 3);
+  for (int i = 0; i < 100; i++) disp.update(now += FRAME_US);
+  CHECK(rasterCalls[0] == 0 && rasterCalls[1] == 0);
+  CHECK(rasterCalls[2] >= 90 && rasterCalls[2] <= 100);
+
+  memset(rasterCalls, 0, sizeof(rasterCalls));
+  strcpy(lastText[1], "novo");
+  disp.setText(2, "novo");
+  for (int i = 0; i < 100; i++) disp.update(now += FRAME_US);
+  CHECK(rasterCalls[0] == 0 && rasterCalls[1] == 1);
+  CHECK(memcmp(mem.ram(), mem.buffer(), FB_WIDTH * FB_PAGES) == 0);
+}
+
+int main() {
+  disp.setBackend(&mem);
+  disp.setRasterizer(countingRaster);
+  CHECK(startDisplay(&disp, 0, 0));
+  testStatic();
+  testScrollOneLine();
+  testRasterizeOnlyChanged();
+  puts("ok");
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_fbdirty.cpp
+ * @brief fbDirty_t: marcação por página, recorte, junção e janelas de envio.
+ */
+
+#include "util/fbDirty.h"
+#include "check.h"
+
+struct run_t {
+  uint8_t p0, p1, x0, x1;
+};
+
+/**
+ * @brief Coleta as janelas de forEachRun().
+ */
+static int runs(const fbDirty_t &d, run_t *out) {
+  int n = 0;
+  d.forEachRun([&](uint8_t p0, uint8_t p1, uint8_t x0, uint8_t x1) { out[n++] = run_t{p0, p1, x0, x1}; });
+  return n;
+}
+
+static void testEmpty() {
+  fbDirty_t d;
+  run_t r[FB_PAGES];
+  CHECK(!d.any() && d.bytes() == 0 && runs(d, r) == 0);
+  d.mark(10, 10, 0, 5);   // largura nula
+  d.mark(-20, 0, 10, 8);  // totalmente à esquerda
+  d.mark(FB_WIDTH, 0, 4, 8);
+  d.mark(0, FB_HEIGHT, 4, 8);
+  CHECK(!d.any());
+}
+
+static void testMark() {
+  fbDirty_t d;
+  d.mark(5, 6, 10, 4);  // linhas 6..9: páginas 0 e 1
+  CHECK(d.x0[0] == 5 && d.x1[0] == 14 && d.x0[1] == 5 && d.x1[1] == 14);
+  CHECK(d.x0[2] > d.x1[2]);
+  CHECK(d.bytes() == 20);
+  d.mark(20, 0, 1, 1);  // amplia só a página 0
+  CHECK(d.x0[0] == 5 && d.x1[0] == 20 && d.x1[1] == 14);
+  d.clear();
+  CHECK(!d.any());
+}
+
+static void testClip() {
+  fbDirty_t d;
+  d.mark(-3, -5, 10, 10);  // vira (0,0) 7x5
+  CHECK(d.x0[0] == 0 && d.x1[0] == 6 && !(d.x0[1] <= d.x1[1]));
+  d.clear();
+  d.mark(FB_WIDTH - 2, FB_HEIGHT - 1, 10, 10);
+  CHECK(d.x0[FB_PAGES - 1] == FB_WIDTH - 2 && d.x1[FB_PAGES - 1] == FB_WIDTH - 1);
+  CHECK(d.bytes() == 2);
+  d.markAll();
+  CHECK(d.bytes() == FB_WIDTH * FB_PAGES);
+}
+
+static void testMerge() {
+  fbDirty_t a, b;
+  a.mark(10, 0, 5, 8);
+  b.mark(0, 0, 2, 8);
+  b.mark(100, 16, 3, 8);
+  a.merge(b);
+  CHECK(a.x0[0] == 0 && a.x1[0] == 14);
+  CHECK(a.x0[2] == 100 && a.x1[2] == 102);
+  CHECK(!(a.x0[1] <= a.x1[1]));
+  fbDirty_t empty;
+  a.merge(empty);  // juntar um conjunto vazio não muda nada
+  CHECK(a.bytes() == 15 + 3);
+}
+
+static void testRuns() {
+  fbDirty_t d;
+  run_t r[FB_PAGES];
+  d.markAll();
+  CHECK(runs(d, r) == 1);
+  CHECK(r[0].p0 == 0 && r[0].p1 == FB_PAGES - 1 && r[0].x0 == 0 && r[0].x1 == FB_WIDTH - 1);
+
+  d.clear();
+  d.mark(0, 0, 16, 16);   // páginas 0-1, colunas 0-15: uma janela
+  d.mark(8, 24, 8, 16);   // páginas 3-4, colunas 8-15: outra (página 2 limpa no meio)
+  d.mark(8, 40, 4, 8);    // página 5 com intervalo diferente: janela própria
+  CHECK(runs(d, r) == 3);
+  CHECK(r[0].p0 == 0 && r[0].p1 == 1 && r[0].x0 == 0 && r[0].x1 == 15);
+  CHECK(r[1].p0 == 3 && r[1].p1 == 4 && r[1].x0 == 8 && r[1].x1 == 15);
+  CHECK(r[2].p0 == 5 && r[2].p1 == 5 && r[2].x0 == 8 && r[2].x1 == 11);
+
+  uint32_t bytes = 0;
+  for (int i = 0; i < 3; i++) bytes += (r[i].p1 - r[i].p0 + 1) * (r[i].x1 - r[i].x0 + 1);
+  CHECK(bytes == d.bytes());
+}
+
+int main() {
+  testEmpty();
+  testMark();
+  testClip();
+  testMerge();
+  testRuns();
+  printf("test_fbdirty: ok\n");
+  return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_fbrenderer.cpp
+ * @brief FbRenderer_c: troca por regiões com um transporte falso, manual (fps = 0) e com a task.
+ */
+
+#include "util/fbRenderer.h"
+#include "check.h"
+#include <stdlib.h>
+#include <thread>
+
+/**
+ * @struct link_t
+ * @brief Transporte falso: RAM do controlador e as células enviadas no último quadro.
+ */
+struct link_t {
+  uint8_t ram[FB_WIDTH * FB_PAGES] = {};
+  uint8_t sent[FB_WIDTH * FB_PAGES] = {}; ///< Vezes que cada byte foi enviado.
+  uint32_t bytes = 0;
+  uint32_t torn = 0;                      ///< Bytes enviados com o valor intermediário 0xFF.
+};
+
+static void send(void *ctx, uint8_t page0, uint8_t page1, uint8_t x0, uint8_t x1, const uint8_t *fb) {
+  link_t *l = (link_t *)ctx;
+  for (uint8_t p = page0; p <= page1; p++)
+    for (uint8_t x = x0; x <= x1; x++) {
+      l->ram[p * FB_WIDTH + x] = fb[p * FB_WIDTH + x];
+      l->sent[p * FB_WIDTH + x]++;
+      l->torn += fb[p * FB_WIDTH + x] == 0xFF;
+      l->bytes++;
+    }
+}
+
+/**
+ * @brief Preenche um retângulo alinhado a páginas com v e o marca em dirty.
+ */
+static void fill(uint8_t *fb, fbDirty_t &dirty, uint8_t x, uint8_t page, uint8_t w, uint8_t pages, uint8_t v) {
+  for (uint8_t p = page; p < page + pages; p++) memset(fb + p * FB_WIDTH + x, v, w);
+  dirty.mark(x, page * 8, w, pages * 8);
+}
+
+/**
+ * @brief As células enviadas são exatamente as de expected, cada uma uma vez.
+ */
+static void checkSent(link_t &l, const fbDirty_t &expected) {
+  for (uint8_t p = 0; p < FB_PAGES; p++)
+    for (uint8_t x = 0; x < FB_WIDTH; x++) {
+      bool want = expected.x0[p] <= x && x <= expected.x1[p];
+      CHECK(l.sent[p * FB_WIDTH + x] == (want ? 1 : 0));
+    }
+  memset(l.sent, 0, sizeof(l.sent));
+}
+
+/**
+ * @brief Sem task: dois commits com uma troca no meio e sem envio entre eles.
+ */
+static void testManual() {
+  static uint8_t back[FB_WIDTH * FB_PAGES];
+  memset(back, 0, sizeof(back));
+  FbRenderer_c r;
+  link_t l;
+  CHECK(r.begin(back, send, &l, 0) && !r.running());
+  fbDirty_t all;
+  all.markAll();
+  CHECK(r.frame() == FB_WIDTH * FB_PAGES);  // primeiro quadro: tela inteira
+  checkSent(l, all);
+  CHECK(r.frame() == 0 && r.frames() == 1);  // nada novo
+
+  // A: trocado para a frente mas não enviado.
+  fbDirty_t dirty, expected;
+  r.lock();
+  fill(back, dirty, 10, 1, 20, 2, 0x11);
+  expected.merge(dirty);
+  r.commit(dirty);
+  r.unlock();
+  CHECK(!dirty.any());
+  CHECK(r.flip());
+  CHECK(r.front()[1 * FB_WIDTH + 10] == 0x11 && l.ram[1 * FB_WIDTH + 10] == 0);
+
+  // B sobrepõe A em parte e a altera; C fica em outra página e só entra pelo commit seguinte.
+  r.lock();
+  fill(back, dirty, 25, 2, 30, 2, 0x22);
+  expected.merge(dirty);
+  r.commit(dirty);
+  fill(back, dirty, 100, 7, 28, 1, 0x33);
+  expected.merge(dirty);
+  r.commit(dirty);
+  r.unlock();
+  // Desenhado sem commit: não pode ir para a frente.
+  back[5 * FB_WIDTH + 64] = 0x44;
+
+  uint32_t bytes = r.frame();
+  CHECK(bytes == expected.bytes() && l.bytes == FB_WIDTH * FB_PAGES + bytes);
+  checkSent(l, expected);
+  CHECK(r.front()[5 * FB_WIDTH + 64] == 0 && l.ram[5 * FB_WIDTH + 64] == 0);
+  back[5 * FB_WIDTH + 64] = 0;
+  CHECK(memcmp(r.front(), back, sizeof(back)) == 0);
+  CHECK(memcmp(l.ram, back, sizeof(back)) == 0);
+  CHECK(r.frames() == 2 && r.bytes() == l.bytes);
+  CHECK(!r.flip() && r.frame() == 0);
+}
+
+/**
+ * @brief Com a task: desenho, commit e trava disputando com a troca.
+ *
+ * Cada desenho passa pelo valor 0xFF antes do valor final, sempre com a trava; se a troca
+ * copiasse fora da trava, o transporte acabaria vendo 0xFF.
+ */
+static void testThreaded() {
+  static uint8_t back[FB_WIDTH * FB_PAGES];
+  memset(back, 0, sizeof(back));
+  FbRenderer_c r;
+  link_t l;
+  CHECK(r.begin(back, send, &l, 500) && r.running());
+  srand(3);
+  fbDirty_t dirty;
+  for (int i = 0; i < 20000; i++) {
+    uint8_t x = rand() % FB_WIDTH, w = 1 + rand() % (FB_WIDTH - x);
+    uint8_t page = rand() % FB_PAGES, pages = 1 + rand() % (FB_PAGES - page);
+    uint8_t v = (uint8_t)(rand() % 0xFF);
+    r.lock();
+    fill(back, dirty, x, page, w, pages, 0xFF);
+    fill(back, dirty, x, page, w, pages, v);
+    if (i % 3) r.commit(dirty);  // às vezes o commit fica para a próxima volta
+    r.unlock();
+    if (i % 200 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  r.lock();
+  r.commit(dirty);
+  r.unlock();
+  r.end();
+  CHECK(!r.running());
+  uint32_t frames = r.frames();
+  r.frame();  // o que a task não chegou a enviar
+  CHECK(frames > 1);
+  CHECK(l.torn == 0);
+  CHECK(memcmp(l.ram, back, sizeof(back)) == 0);
+  CHECK(r.bytes() == l.bytes);
+  printf("quadros da task=%u bytes=%u\n", (unsigned)frames, (unsigned)l.bytes);
+}
+
+int main() {
+  testManual();
+  testThreaded();
+  puts("ok");
+  return 0;
+}
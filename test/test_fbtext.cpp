@@ -0,0 +1,131 @@
+/**
+ * @file test_fbtext.cpp
+ * @brief Faixas em cache (fbStripBlit) contra a cópia pixel a pixel (fbBlitRows), e a rolagem
+ * de FbScreen_c com cache contra a rasterização a cada quadro.
+ */
+
+#include "util/fbScreen.h"
+#include "check.h"
+#include <stdlib.h>
+
+static uint8_t rows[(FB_STRIP_WIDTH + 7) / 8 * FB_STRIP_HEIGHT];
+static fbStrip_t strip;
+
+/**
+ * @brief Bitmap aleatório w × h, convertido também em faixa.
+ */
+static void randomRows(uint16_t w, uint8_t h) {
+  for (size_t i = 0; i < sizeof(rows); i++) rows[i] = (uint8_t)rand();
+  CHECK(fbStripFromRows(strip, rows, w, h));
+}
+
+/**
+ * @brief As duas cópias sobre o mesmo fundo aleatório devem dar o mesmo framebuffer.
+ */
+static void compare(uint16_t w, uint8_t h, int16_t x, int16_t y) {
+  uint8_t a[FB_WIDTH * FB_PAGES], b[FB_WIDTH * FB_PAGES];
+  for (size_t i = 0; i < sizeof(a); i++) a[i] = b[i] = (uint8_t)(rand() & rand());
+  fbStripBlit(a, strip, x, y);
+  fbBlitRows(b, rows, w, h, x, y);
+  CHECK(memcmp(a, b, sizeof(a)) == 0);
+}
+
+/**
+ * @brief Todos os deslocamentos y & 7, x negativo, dentro e além da borda direita.
+ */
+static void testBlit() {
+  srand(7);
+  static const int16_t xs[] = {-300, -257, -100, -1, 0, 1, 5, 64, 100, 127, 128, 200};
+  for (uint8_t h = 1; h <= FB_STRIP_HEIGHT; h += 7) {
+    for (uint16_t w = 1; w <= FB_STRIP_WIDTH; w += 51) {
+      randomRows(w, h);
+      for (int16_t x : xs)
+        for (int16_t y = 0; y < FB_HEIGHT; y++) compare(w, h, x, y);
+    }
+  }
+  for (int i = 0; i < 20000; i++) {
+    uint16_t w = 1 + rand() % FB_STRIP_WIDTH;
+    uint8_t h = 1 + rand() % FB_STRIP_HEIGHT;
+    randomRows(w, h);
+    compare(w, h, (int16_t)(rand() % 600 - 300), (int16_t)(rand() % FB_HEIGHT));
+  }
+}
+
+/**
+ * @brief Rasterizar com deslocamento x é o mesmo que copiar a faixa rasterizada em 0 para x.
+ */
+static void testTextOffset() {
+  const char *text = "Ola, IIKit! 0123~";
+  for (uint8_t size = 1; size <= 3; size++) {
+    uint16_t w = 6 * size * strlen(text);
+    uint8_t h = 8 * size;
+    if (w > FB_STRIP_WIDTH) continue;
+    CHECK(fbTextRows(rows, w, h, 0, text, size));
+    CHECK(fbStripFromRows(strip, rows, w, h));
+    uint8_t frame[(FB_WIDTH + 7) / 8 * FB_STRIP_HEIGHT];
+    for (int16_t x = -(int16_t)w - 2; x <= FB_WIDTH + 2; x++) {
+      uint8_t a[FB_WIDTH * FB_PAGES] = {}, b[FB_WIDTH * FB_PAGES] = {};
+      fbStripBlit(a, strip, x, 20);
+      CHECK(fbTextRows(frame, FB_WIDTH, h, x, text, size));
+      fbBlitRows(b, frame, FB_WIDTH, h, 0, 20);
+      CHECK(memcmp(a, b, sizeof(a)) == 0);
+    }
+  }
+}
+
+/**
+ * @struct screen_t
+ * @brief FbScreen_c que pode desligar o cache, forçando a rasterização a cada quadro.
+ */
+struct screen_t : FbScreen_c {
+  explicit screen_t(FbBackend_c *target) : FbScreen_c(target) {}
+  bool cached = true;
+  void set(uint8_t line, const char *txt, uint8_t size) {
+    setText(line, txt, size);
+    if (!cached)
+      for (fbStrip_t &s : strips) s.height = 0;
+  }
+  bool usesCache(uint8_t index) const { return strips[index].height != 0; }
+};
+
+/**
+ * @brief Mesma sequência de textos e instantes nas duas telas: quadros idênticos.
+ */
+static void testScroll() {
+  FbMemory_c memA, memB;
+  screen_t a(&memA), b(&memB);
+  b.cached = false;
+  CHECK(a.begin() && b.begin());
+  static const struct {
+    uint8_t line;
+    const char *txt;
+    uint8_t size;
+  } steps[] = {
+      {1, "Uma linha que rola", 2}, {2, "curta", 2},           {3, "outra linha longa", 1},
+      {2, "tamanho tres rola", 3},    {1, "", 2},                {3, "abc", 2},
+      {1, "de volta a rolar!!", 2},   {2, "x", 1},               {3, "fim da sequencia", 2},
+  };
+  unsigned long t = 0;
+  for (const auto &s : steps) {
+    a.set(s.line, s.txt, s.size);
+    b.set(s.line, s.txt, s.size);
+    // "tamanho tres rola" em tamanho 3 não cabe numa faixa: as duas telas rasterizam por quadro.
+    CHECK(a.usesCache(s.line - 1) == (6 * s.size * strlen(s.txt) <= FB_STRIP_WIDTH));
+    CHECK(!b.usesCache(s.line - 1));
+    for (int f = 0; f < 150; f++) {
+      t += 13000 + (f % 5) * 9000;  // quadros irregulares: rolagem de 0 a 2 pixels
+      a.update(t);
+      b.update(t);
+      CHECK(memcmp(memA.ram(), memB.ram(), FB_WIDTH * FB_PAGES) == 0);
+      CHECK(memcmp(memA.ram(), memA.buffer(), FB_WIDTH * FB_PAGES) == 0);
+    }
+  }
+}
+
+int main() {
+  testBlit();
+  testTextOffset();
+  testScroll();
+  puts("ok");
+  return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_fbtrend.cpp
+ * @brief FbTrend_c: desenho incremental (deslocamento + colunas novas) contra o redesenho completo.
+ */
+
+#include "util/fbTrend.h"
+#include "check.h"
+#include <stdlib.h>
+#include <vector>
+
+static uint8_t background[FB_WIDTH * FB_PAGES];
+
+/**
+ * @brief O framebuffer desenhado incrementalmente deve ser igual ao de uma cópia do gráfico
+ * redesenhada por inteiro (invalidate()) sobre o mesmo fundo; fora da região nada muda.
+ */
+static void checkAgainstRedraw(const FbTrend_c &trend, const uint8_t *fb) {
+  FbTrend_c ref = trend;
+  uint8_t expected[FB_WIDTH * FB_PAGES];
+  memcpy(expected, background, sizeof(expected));
+  fbDirty_t dirty;
+  ref.invalidate();
+  ref.draw(expected, dirty);
+  CHECK(memcmp(fb, expected, sizeof(expected)) == 0);
+}
+
+/**
+ * @brief Intervalo dos dados nas últimas w colunas (1 amostra por coluna, cada coluna ligada à anterior).
+ */
+static void dataRange(const std::vector<int32_t> &v, uint8_t w, int32_t &lo, int32_t &hi) {
+  size_t first = v.size() > w ? v.size() - w : 0;
+  if (first) first--;  // a coluna mais antiga inclui a amostra anterior
+  lo = hi = v[first];
+  for (size_t i = first; i < v.size(); i++) {
+    if (v[i] < lo) lo = v[i];
+    if (v[i] > hi) hi = v[i];
+  }
+}
+
+/**
+ * @brief Passos aleatórios de push/draw numa região que não começa em página inteira.
+ * @param fixed Usa escala fixa (com valores fora dela, recortados).
+ */
+static void testRandom(uint8_t x, uint8_t y, uint8_t w, uint8_t h, bool fixed, uint16_t perColumn) {
+  for (size_t i = 0; i < sizeof(background); i++) background[i] = (uint8_t)rand();
+  uint8_t fb[FB_WIDTH * FB_PAGES];
+  memcpy(fb, background, sizeof(fb));
+  FbTrend_c trend(x, y, w, h, perColumn);
+  if (fixed) trend.setRange(-500, 500);
+  fbDirty_t dirty;
+  int32_t v = 0;
+  uint32_t incremental = 0;
+  for (int step = 0; step < 3000; step++) {
+    int pushes = rand() % 4 == 0 ? rand() % (3 * w * perColumn / 2) : rand() % (3 * perColumn);
+    for (int k = 0; k < pushes; k++) {
+      v += rand() % 81 - 40;
+      if (rand() % 500 == 0) v += rand() % 4000 - 2000;  // degrau: muda a escala automática
+      trend.push(v);
+    }
+    uint32_t before = trend.redraws();
+    bool pending = trend.pending();
+    trend.draw(fb, dirty);
+    if (pending && trend.redraws() == before) incremental++;
+    checkAgainstRedraw(trend, fb);
+    if (!fixed) CHECK(trend.lo() < trend.hi());
+  }
+  CHECK(dirty.any());
+  CHECK(incremental > 1000);  // o caminho incremental foi de fato exercitado
+  if (fixed) CHECK(trend.lo() == -500 && trend.hi() == 500);
+}
+
+/**
+ * @brief O pico sai do anel: a escala automática é recalculada e o gráfico redesenhado,
+ * e só nesse momento.
+ */
+static void testEvictExtreme() {
+  memset(background, 0, sizeof(background));
+  uint8_t fb[FB_WIDTH * FB_PAGES] = {};
+  const uint8_t w = 32;
+  FbTrend_c trend(10, 21, w, 30);
+  fbDirty_t dirty;
+  std::vector<int32_t> v;
+  auto push = [&](int32_t s) {
+    v.push_back(s);
+    trend.push(s);
+    trend.draw(fb, dirty);
+    checkAgainstRedraw(trend, fb);
+    int32_t lo, hi;
+    dataRange(v, w, lo, hi);
+    CHECK(trend.lo() <= lo && trend.hi() >= hi);  // os dados cabem na escala exibida
+  };
+  for (int i = 0; i < 40; i++) push(100 + i % 5);
+  push(10000);  // pico
+  uint32_t afterSpike = trend.redraws();
+  int32_t spikeHi = trend.hi();
+  CHECK(spikeHi >= 10000);
+  // Enquanto o pico (e a amostra seguinte, ligada a ele) está no anel a escala não muda.
+  for (int i = 0; i < w - 1; i++) {
+    push(100 + i % 5);
+    CHECK(trend.hi() == spikeHi && trend.redraws() == afterSpike);
+  }
+  push(100);  // a coluna do pico sai do anel
+  push(101);  // e a que se ligava a ele
+  CHECK(trend.hi() < 200 && trend.redraws() == afterSpike + 1);
+  // Um mínimo que sai do anel também reajusta a escala.
+  push(-5000);
+  uint32_t afterDip = trend.redraws();
+  for (int i = 0; i < w + 1; i++) push(100 + i % 5);
+  CHECK(trend.lo() > 0 && trend.redraws() == afterDip + 1);
+}
+
+/**
+ * @brief Sinal constante: a escala se ajusta uma vez e as colunas seguintes são incrementais.
+ */
+static void testFlat() {
+  memset(background, 0, sizeof(background));
+  uint8_t fb[FB_WIDTH * FB_PAGES] = {};
+  FbTrend_c trend(0, 40, FB_WIDTH, 24);
+  fbDirty_t dirty;
+  for (int i = 0; i < 500; i++) {
+    trend.push(i < 250 ? 42 : 43);
+    trend.draw(fb, dirty);
+    checkAgainstRedraw(trend, fb);
+  }
+  CHECK(trend.lo() <= 42 && trend.hi() >= 43);
+  CHECK(trend.redraws() <= 3);
+}
+
+/**
+ * @brief Mais colunas novas que a largura de uma vez, clear() e setAutoRange() depois de escala fixa.
+ */
+static void testBursts() {
+  for (size_t i = 0; i < sizeof(background); i++) background[i] = (uint8_t)rand();
+  uint8_t fb[FB_WIDTH * FB_PAGES];
+  memcpy(fb, background, sizeof(fb));
+  FbTrend_c trend(0, 3, FB_WIDTH, 58, 2);
+  fbDirty_t dirty;
+  for (int i = 0; i < 1000; i++) trend.push(i * 37 % 101);
+  trend.draw(fb, dirty);
+  checkAgainstRedraw(trend, fb);
+  trend.setRange(0, 50);
+  trend.draw(fb, dirty);
+  checkAgainstRedraw(trend, fb);
+  for (int i = 0; i < 9; i++) trend.push(i * 13);
+  trend.draw(fb, dirty);
+  checkAgainstRedraw(trend, fb);
+  trend.setAutoRange();
+  CHECK(trend.lo() < 0 && trend.hi() > 100);
+  trend.draw(fb, dirty);
+  checkAgainstRedraw(trend, fb);
+  trend.clear();
+  trend.draw(fb, dirty);
+  checkAgainstRedraw(trend, fb);
+  for (int i = 0; i < 7; i++) trend.push(i);
+  trend.draw(fb, dirty);
+  checkAgainstRedraw(trend, fb);
+}
+
+int main() {
+  srand(11);
+  testRandom(5, 13, 100, 29, false, 1);  // começa no meio da página 1, termina na página 5
+  testRandom(5, 13, 100, 29, true, 1);
+  testRandom(0, 16, FB_WIDTH, 48, false, 3);  // páginas inteiras: memmove
+  testRandom(30, 60, 40, 4, true, 2);         // dentro de uma só página
+  testRandom(0, 0, 17, 1, false, 1);          // uma linha
+  testEvictExtreme();
+  testFlat();
+  testBursts();
+  puts("ok");
+  return 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file test_jcoro.cpp
+ * @brief Corrotinas do jtask com relógio simulado: arena, instantes de retomada e espera em fila.
+ */
+
+#include "util/jcoro.h"
+#include "check.h"
+
+static unsigned long fakeNow = 0;
+static unsigned long fakeClock() { return fakeNow; }
+
+/**
+ * @brief Avança o relógio até until, em passos de step, com uma passagem de jtaskLoop() em cada.
+ */
+static void runUntil(unsigned long until, unsigned long step = 100) {
+  while (fakeNow < until) {
+    fakeNow += step;
+    jtaskLoop();
+  }
+}
+
+/**
+ * @struct trace_t
+ * @brief Instantes em que uma corrotina foi retomada.
+ */
+struct trace_t {
+  int n = 0;
+  unsigned long at[32];
+  void mark() {
+    if (n < 32) at[n] = jtaskNow();
+    n++;
+  }
+};
+
+static jcoro_t forever(trace_t *t) {
+  for (;;) {
+    t->mark();
+    co_await jcoroNextPeriod();
+  }
+}
+
+static jcoro_t tooBig(trace_t *t) {
+  volatile unsigned char local[JCORO_FRAME_SIZE];  // vive através da suspensão: vai para o quadro
+  local[0] = 1;
+  co_await jcoroSleep(10);
+  t->mark();
+  (void)local[0];
+}
+
+/**
+ * @brief Arena cheia e quadro grande demais: a corrotina não é criada, jcoroStart() falha sem
+ * efeitos colaterais, e o bloco volta a ficar livre com jcoroStop(), com o fim da corrotina ou
+ * com a destruição de um jcoro_t não iniciado.
+ */
+static void testArena() {
+  CHECK(jcoroArenaAvailable() == JCORO_FRAMES);
+  trace_t t[JCORO_FRAMES + 1];
+  int id[JCORO_FRAMES];
+  for (int i = 0; i < JCORO_FRAMES; i++) {
+    id[i] = jcoroStart(forever(&t[i]), 1000);
+    CHECK(id[i] >= 0);
+  }
+  CHECK(jcoroArenaAvailable() == 0 && jcoroArenaFailures == 0);
+  uint8_t tasks = jtaskIndex;
+  {
+    jcoro_t extra = forever(&t[JCORO_FRAMES]);
+    CHECK(!extra.valid() && jcoroArenaFailures == 1);
+    CHECK(jcoroStart(std::move(extra), 1000) == JTASK_INVALID);
+  }
+  CHECK(jcoroStart(forever(&t[JCORO_FRAMES]), 1000) == JTASK_INVALID && jcoroArenaFailures == 2);
+  CHECK(jtaskIndex == tasks);
+  runUntil(fakeNow + 3000);
+  CHECK(t[JCORO_FRAMES].n == 0);
+  for (int i = 0; i < JCORO_FRAMES; i++) CHECK(t[i].n >= 3);
+
+  CHECK(jcoroStop(id[0]) && !jcoroStop(id[0]) && jcoroArenaAvailable() == 1);
+  {
+    jcoro_t unstarted = forever(&t[JCORO_FRAMES]);
+    CHECK(unstarted.valid() && jcoroArenaAvailable() == 0);
+  }
+  CHECK(jcoroArenaAvailable() == 1);
+
+  // Quadro maior que JCORO_FRAME_SIZE: falha mesmo com blocos livres.
+  CHECK(jcoroStart(tooBig(&t[JCORO_FRAMES]), 0) == JTASK_INVALID && jcoroArenaFailures == 3);
+  CHECK(jcoroArenaAvailable() == 1);
+
+  id[0] = jcoroStart(forever(&t[JCORO_FRAMES]), 1000);
+  CHECK(id[0] >= 0 && jcoroArenaAvailable() == 0);
+  runUntil(fakeNow + 1000);
+  CHECK(t[JCORO_FRAMES].n >= 1);
+  for (int i = 0; i < JCORO_FRAMES; i++) CHECK(jcoroStop(id[i]));
+  CHECK(jcoroArenaAvailable() == JCORO_FRAMES && jtaskIndex == 0);
+}
+
+/**
+ * @brief Pool do jtask cheio: jcoroStart() devolve o quadro à arena.
+ */
+static void testPoolFull() {
+  int dummy[8];
+  int n = 0;
+  while (n < 8 && (dummy[n] = jtaskAttach([] {}, 1000000)) >= 0) n++;
+  trace_t t;
+  CHECK(jcoroStart(forever(&t), 1000) == JTASK_INVALID);
+  CHECK(jcoroArenaAvailable() == JCORO_FRAMES);
+  for (int i = 0; i < n; i++) CHECK(jtaskDetach(dummy[i]));
+}
+
+static jcoro_t sequence(trace_t *t) {
+  t->mark();                        // primeira passagem após jcoroStart()
+  co_await jcoroSleep(1200);
+  t->mark();                        // início + 1200
+  co_await jcoroNextPeriod();
+  t->mark();                        // início + 10000 (fase fixa, não início + 1200 + 10000)
+  co_await jcoroSleep(3000);
+  t->mark();
+  co_await jcoroNextPeriod();
+  t->mark();                        // início + 20000
+  co_await jcoroNextPeriod();       // o loop atrasa: as liberações perdidas são puladas
+  t->mark();
+  co_await jcoroNextPeriod();
+  t->mark();
+}
+
+/**
+ * @brief jcoroSleep() conta a partir do instante da suspensão; jcoroNextPeriod() mantém a fase.
+ */
+static void testResumeTimes() {
+  fakeNow = 100000;
+  trace_t t;
+  int id = jcoroStart(sequence(&t), 10000);
+  CHECK(id >= 0);
+  jtaskLoop();  // liberada no instante do início
+  CHECK(t.n == 1 && t.at[0] == 100000);
+  runUntil(100000 + 1199, 1);
+  CHECK(t.n == 1);
+  runUntil(100000 + 1200, 1);
+  CHECK(t.n == 2 && t.at[1] == 101200);
+  runUntil(110000 - 1, 7);
+  CHECK(t.n == 2);
+  runUntil(110000, 1);
+  CHECK(t.n == 3 && t.at[2] == 110000);
+  runUntil(113000, 1);
+  CHECK(t.n == 4 && t.at[3] == 113000);
+  runUntil(120000, 1);
+  CHECK(t.n == 5 && t.at[4] == 120000);
+  fakeNow = 145500;  // perde as liberações de 130000 e 140000
+  jtaskLoop();
+  CHECK(t.n == 6 && t.at[5] == 145500);
+  jtaskLoop();
+  CHECK(t.n == 6 && jtaskNextWakeup() == 4500);  // próxima em 150000, na fase original
+  fakeNow = 150000;
+  jtaskLoop();
+  CHECK(t.n == 7 && t.at[6] == 150000);
+  CHECK(!jtaskStats(id) && jcoroArenaAvailable() == JCORO_FRAMES);  // terminou: entrada e quadro livres
+}
+
+static void *received[4];
+static unsigned long receivedAt[4];
+
+static jcoro_t consumer(jQueue_t *q, int count) {
+  for (int i = 0; i < count; i++) {
+    void *item = co_await jcoroReceive(q, 500);
+    received[i] = item;
+    receivedAt[i] = jtaskNow();
+  }
+}
+
+/**
+ * @brief jcoroReceive() acorda na primeira verificação depois do envio, sem retomar antes.
+ */
+static void testReceive() {
+  jQueue_t q;
+  jQueueInit(&q);
+  fakeNow = 200000;
+  int id = jcoroStart(consumer(&q, 3), 0);
+  CHECK(id >= 0);
+  jtaskLoop();  // suspende na fila vazia: verificações em 200500, 201000, ...
+  runUntil(205300, 1);
+  CHECK(received[0] == nullptr);
+  CHECK(jQueueSendFromISR(&q, (void *)0x11));
+  runUntil(205500 - 1, 1);
+  CHECK(received[0] == nullptr);
+  runUntil(205500, 1);
+  CHECK(received[0] == (void *)0x11 && receivedAt[0] == 205500);
+
+  // Dois itens durante a espera: o primeiro na próxima verificação; o segundo já está na
+  // fila no co_await seguinte, que então não suspende.
+  CHECK(jQueueSendFromISR(&q, (void *)0x22) && jQueueSendFromISR(&q, (void *)0x33));
+  runUntil(206000 - 1, 1);
+  CHECK(received[1] == nullptr);
+  runUntil(206000, 1);
+  CHECK(received[1] == (void *)0x22 && receivedAt[1] == 206000);
+  CHECK(received[2] == (void *)0x33 && receivedAt[2] == 206000);
+  CHECK(!jtaskStats(id) && jcoroArenaAvailable() == JCORO_FRAMES);
+}
+
+int main() {
+  jtaskSetClock(fakeClock);
+  CHECK(jtaskSetup(8));
+  testArena();
+  testPoolFull();
+  testResumeTimes();
+  testReceive();
+  puts("ok");
+  return 0;
+}
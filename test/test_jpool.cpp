@@ -0,0 +1,84 @@
+/**
+ * @file test_jpool.cpp
+ * @brief JPool: esgotamento, validação de ponteiros e posse exclusiva sob disputa (ABA).
+ */
+
+#include "util/jpool.h"
+#include "check.h"
+#include <atomic>
+#include <thread>
+
+/**
+ * @brief Esgota o pool, devolve fora de ordem e confere contadores e índices.
+ */
+static void testExhaustion() {
+  typedef JPool<12, 4> Pool;
+  Pool pool;
+  static_assert(Pool::STRIDE == 16, "blocos alinhados a 8");
+  void *b[4];
+  for (int i = 0; i < 4; i++) {
+    b[i] = pool.alloc();
+    CHECK(b[i] != nullptr);
+    CHECK(((uintptr_t)b[i] & 7) == 0);
+    CHECK(pool.at(pool.indexOf(b[i])) == b[i]);
+  }
+  CHECK(pool.alloc() == nullptr);
+  CHECK(pool.exhaustions() == 1 && pool.inUse() == 4 && pool.highWater() == 4);
+
+  int outside;
+  CHECK(!pool.free(&outside));                     // não pertence ao pool
+  CHECK(!pool.free((unsigned char *)b[0] + 1));    // não é o início de um bloco
+  CHECK(pool.indexOf(&outside) == Pool::NIL);
+
+  CHECK(pool.free(b[2]) && pool.free(b[0]));
+  CHECK(pool.inUse() == 2);
+  CHECK(pool.alloc() == b[0]);  // pilha: o último devolvido sai primeiro
+  CHECK(pool.alloc() == b[2]);
+  CHECK(pool.alloc() == nullptr && pool.exhaustions() == 2);
+  for (int i = 0; i < 4; i++) CHECK(pool.free(b[i]));
+  CHECK(pool.inUse() == 0 && pool.highWater() == 4);
+}
+
+/**
+ * @brief Threads pegam e devolvem blocos sem parar; um bloco nunca pode ter dois donos.
+ *
+ * Com a lista de livres vulnerável a ABA, dois alloc() acabariam devolvendo o mesmo bloco, e
+ * a marca gravada por uma thread seria sobrescrita pela outra.
+ */
+static void testContention() {
+  static const int THREADS = 4, ROUNDS = 50000;
+  JPool<sizeof(uint32_t), 3> pool;  // menos blocos que threads: força esgotamento e reuso
+  std::atomic<uint32_t> owners[3] = {};
+  std::thread threads[THREADS];
+  for (int t = 0; t < THREADS; t++) {
+    threads[t] = std::thread([&, t] {
+      for (int r = 0; r < ROUNDS; r++) {
+        uint32_t *b = (uint32_t *)pool.alloc();
+        if (!b) {
+          std::this_thread::yield();
+          continue;
+        }
+        uint16_t i = pool.indexOf(b);
+        CHECK(owners[i].fetch_add(1) == 0);
+        *b = t;
+        if (r % 16 == 0) std::this_thread::yield();
+        CHECK(*b == (uint32_t)t);
+        owners[i].fetch_sub(1);
+        CHECK(pool.free(b));
+      }
+    });
+  }
+  for (int t = 0; t < THREADS; t++) threads[t].join();
+  CHECK(pool.inUse() == 0);
+  CHECK(pool.highWater() <= 3);
+  void *b[3];
+  for (int i = 0; i < 3; i++) CHECK((b[i] = pool.alloc()) != nullptr);  // nenhum bloco se perdeu
+  CHECK(pool.alloc() == nullptr);
+}
+
+int main() {
+  testExhaustion();
+  testContention();
+  printf("test_jpool: ok\n");
+  return 0;
+}
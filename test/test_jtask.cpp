@@ -0,0 +1,238 @@
+/**
+ * @file test_jtask.cpp
+ * @brief jtask com relógio simulado: liberações travadas em fase, políticas de overrun e sono até o prazo.
+ */
+
+#include "util/jtaskIdle.h"
+#include "check.h"
+#include <stdlib.h>
+
+static unsigned long fakeNow = 0;
+static unsigned long fakeClock() { return fakeNow; }
+
+/**
+ * @struct log_t
+ * @brief Instantes de cada execução de uma tarefa: liberação prevista e relógio do escalonador.
+ */
+struct log_t {
+  int id;
+  int n;
+  unsigned long release[64];
+  unsigned long at[64];
+};
+
+static void record(void *ctx) {
+  log_t *l = (log_t *)ctx;
+  if (l->n < 64) {
+    l->release[l->n] = jtaskStruct[l->id].release;
+    l->at[l->n] = jtaskNow();
+  }
+  l->n++;
+}
+
+static int attach(log_t &l, unsigned long period, jtaskOverrun_t policy) {
+  l.n = 0;
+  l.id = jtaskAttach(record, &l, period, policy);
+  CHECK(l.id >= 0);
+  return l.id;
+}
+
+/**
+ * @brief Passagens em instantes irregulares: as liberações ficam em múltiplos exatos do período.
+ */
+static void testPhaseLock() {
+  fakeNow = 5000;
+  log_t l;
+  int id = attach(l, 1000, JTASK_SKIP);
+  srand(5);
+  unsigned long maxLate = 0;
+  while (l.n < 60) {
+    fakeNow += 1 + rand() % 700;  // sempre menos de um período entre passagens
+    jtaskLoop();
+  }
+  for (int k = 0; k < 60; k++) {
+    CHECK(l.release[k] == 5000 + 1000UL * (k + 1));
+    unsigned long late = l.at[k] - l.release[k];
+    CHECK(late < 700);
+    if (late > maxLate) maxLate = late;
+  }
+  const TaskStats_t *st = jtaskStats(id);
+  CHECK(st->runs == 60 && st->missed == 0 && st->jitterMax == maxLate);
+  CHECK(jtaskDetach(id));
+}
+
+/**
+ * @brief Atraso de 2,5 períodos com cada política.
+ *
+ * Tarefa de período 1000 registrada em 0, primeira passagem em 3500:
+ *  - SKIP roda uma vez (liberação 1000), conta 2 perdidas e volta à fase: próxima em 4000.
+ *  - CATCH_UP roda 1000, 2000 e 3000, uma por passagem, e então segue em 4000.
+ *  - REALIGN roda uma vez e passa a contar de 3500: próxima em 4500.
+ */
+static void testOverrun() {
+  log_t l;
+
+  fakeNow = 0;
+  int id = attach(l, 1000, JTASK_SKIP);
+  fakeNow = 3500;
+  jtaskLoop();
+  jtaskLoop();
+  CHECK(l.n == 1 && l.release[0] == 1000 && jtaskStats(id)->missed == 2);
+  CHECK(jtaskNextWakeup() == 500);
+  fakeNow = 4000;
+  jtaskLoop();
+  CHECK(l.n == 2 && l.release[1] == 4000 && l.at[1] == 4000);
+  CHECK(jtaskDetach(id));
+
+  fakeNow = 0;
+  id = attach(l, 1000, JTASK_CATCH_UP);
+  fakeNow = 3500;
+  for (int pass = 0; pass < 5; pass++) jtaskLoop();
+  CHECK(l.n == 3 && l.release[0] == 1000 && l.release[1] == 2000 && l.release[2] == 3000);
+  CHECK(jtaskStats(id)->missed == 2);  // 1000 e 2000 começaram com mais de um período de atraso
+  CHECK(jtaskNextWakeup() == 500);
+  fakeNow = 4000;
+  jtaskLoop();
+  CHECK(l.n == 4 && l.release[3] == 4000);
+  CHECK(jtaskDetach(id));
+
+  fakeNow = 0;
+  id = attach(l, 1000, JTASK_REALIGN);
+  fakeNow = 3500;
+  jtaskLoop();
+  jtaskLoop();
+  CHECK(l.n == 1 && l.release[0] == 1000 && jtaskStats(id)->missed == 2);
+  CHECK(jtaskNextWakeup() == 1000);
+  fakeNow = 4499;
+  jtaskLoop();
+  CHECK(l.n == 1);
+  fakeNow = 4500;
+  jtaskLoop();
+  CHECK(l.n == 2 && l.release[1] == 4500);
+  CHECK(jtaskDetach(id));
+}
+
+/**
+ * @brief jtaskNextWakeup(): sem tarefas, a mais próxima entre várias e vencida.
+ */
+static void testNextWakeup() {
+  CHECK(jtaskNextWakeup() == JTASK_NO_TASK);
+  fakeNow = 100;
+  log_t a, b;
+  int ia = attach(a, 700, JTASK_SKIP), ib = attach(b, 300, JTASK_SKIP);
+  CHECK(jtaskNextWakeup() == 300);
+  fakeNow = 350;
+  CHECK(jtaskNextWakeup() == 50);
+  fakeNow = 450;
+  CHECK(jtaskNextWakeup() == 0);
+  jtaskLoop();
+  CHECK(b.n == 1 && a.n == 0 && jtaskNextWakeup() == 250);  // b em 700, a em 800
+  CHECK(jtaskDetach(ia) && jtaskDetach(ib));
+}
+
+/**
+ * @brief Decisão de sono (função pura).
+ */
+static void testDecide() {
+  jtaskIdleConfig_t cfg = {1000, 20000, 2000, false};
+  unsigned long us = 123;
+  CHECK(jtaskIdleDecide(50000, true, cfg, us) == JTASK_IDLE_NONE && us == 0);
+  CHECK(jtaskIdleDecide(JTASK_NO_TASK, false, cfg, us) == JTASK_IDLE_NONE);
+  CHECK(jtaskIdleDecide(999, false, cfg, us) == JTASK_IDLE_NONE);
+  CHECK(jtaskIdleDecide(1000, false, cfg, us) == JTASK_IDLE_YIELD && us == 1000);
+  CHECK(jtaskIdleDecide(5999, false, cfg, us) == JTASK_IDLE_YIELD && us == 5000);  // ticks inteiros, sem passar
+  CHECK(jtaskIdleDecide(50000, false, cfg, us) == JTASK_IDLE_YIELD && us == 50000);
+  cfg.lightSleep = true;
+  CHECK(jtaskIdleDecide(19999, false, cfg, us) == JTASK_IDLE_YIELD && us == 19000);
+  CHECK(jtaskIdleDecide(20000, false, cfg, us) == JTASK_IDLE_LIGHT_SLEEP && us == 18000);
+  CHECK(jtaskIdleDecide(50000, true, cfg, us) == JTASK_IDLE_NONE);
+  cfg.wakeLatencyUs = 30000;  // latência maior que a espera: não compensa
+  CHECK(jtaskIdleDecide(25000, false, cfg, us) == JTASK_IDLE_YIELD && us == 25000);
+}
+
+/**
+ * @brief Sono simulado: o relógio de referência sempre anda; o do escalonador para no light
+ * sleep quando frozen é true, como o micros() sem compensação.
+ */
+static int64_t refNow = 0;
+static int64_t refClock() { return refNow; }
+static bool frozen = false;
+static int sleeps = 0;
+static jtaskIdleAction_t lastAction;
+static unsigned long lastSleep;
+static void fakeSleep(jtaskIdleAction_t action, unsigned long us) {
+  sleeps++;
+  lastAction = action;
+  lastSleep = us;
+  refNow += us;
+  if (!(frozen && action == JTASK_IDLE_LIGHT_SLEEP)) fakeNow += us;
+}
+static bool ioBusy = false;
+static bool ioPending() { return ioBusy; }
+
+/**
+ * @brief jtaskIdle() entre passagens: dorme o intervalo calculado e a tarefa roda no prazo,
+ * com e sem o relógio do escalonador parado durante o light sleep.
+ */
+static void testIdle() {
+  jtaskIdleRefClock = refClock;
+  jtaskIdleSleep = fakeSleep;
+  jtaskIdleIoPending = ioPending;
+  jtaskIdleCfg = jtaskIdleConfig_t{1000, 20000, 2000, false};
+  fakeNow = 10000;
+  refNow = 777;
+  log_t l;
+  int id = attach(l, 50500, JTASK_SKIP);
+
+  // E/S pendente: não dorme.
+  ioBusy = true;
+  CHECK(jtaskIdle() == 0 && sleeps == 0);
+  ioBusy = false;
+
+  // Só vTaskDelay: 50 ticks, depois o restante (500 µs) é menor que um tick e o loop gira.
+  CHECK(jtaskIdle() == 50000 && lastAction == JTASK_IDLE_YIELD && fakeNow == 60000);
+  CHECK(jtaskIdle() == 0 && sleeps == 1);
+  fakeNow += 500;
+  jtaskLoop();
+  CHECK(l.n == 1 && l.at[0] == l.release[0] && l.release[0] == 60500);
+  CHECK(jtaskClockSkew == 0 && jtaskIdleSleptUs == 50000);
+
+  // Light sleep com o relógio do escalonador parado: a diferença vira jtaskClockSkew.
+  jtaskIdleCfg.lightSleep = true;
+  frozen = true;
+  unsigned long slept = jtaskIdle();
+  CHECK(lastAction == JTASK_IDLE_LIGHT_SLEEP && lastSleep == 50500 - 2000 && slept == lastSleep);
+  CHECK(fakeNow == 60500 && jtaskClockSkew == lastSleep);
+  CHECK(jtaskNextWakeup() == 2000);
+  // O restante (2000 µs) é curto para light sleep: vTaskDelay, com o relógio andando.
+  CHECK(jtaskIdle() == 2000 && lastAction == JTASK_IDLE_YIELD);
+  jtaskLoop();
+  CHECK(l.n == 2 && l.release[1] == 111000 && l.at[1] == 111000);
+
+  // Light sleep com os dois relógios andando: nada a compensar.
+  frozen = false;
+  unsigned long skew = jtaskClockSkew;
+  CHECK(jtaskIdle() == 48500 && lastAction == JTASK_IDLE_LIGHT_SLEEP && jtaskClockSkew == skew);
+  CHECK(jtaskIdle() == 2000);
+  jtaskLoop();
+  CHECK(l.n == 3 && l.at[2] == 161500 && jtaskStats(id)->jitterMax == 0);
+
+  CHECK(jtaskDetach(id));
+  CHECK(jtaskIdle() == 0);  // sem tarefas
+  jtaskClockSkew = 0;
+  jtaskIdleRefClock = jtaskIdleDefaultRefClock;
+  jtaskIdleSleep = jtaskIdleDefaultSleep;
+  jtaskIdleIoPending = nullptr;
+}
+
+int main() {
+  jtaskSetClock(fakeClock);
+  CHECK(jtaskSetup(8));
+  testPhaseLock();
+  testOverrun();
+  testNextWakeup();
+  testDecide();
+  testIdle();
+  puts("ok");
+  return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file test_jtaskpool.cpp
+ * @brief Executor do jtask sobre std::thread: afinidade, roubo e contagem de candidatas a roubo.
+ */
+
+#include "util/jtaskPool.h"
+#include "check.h"
+#include <atomic>
+#include <thread>
+
+static std::atomic<unsigned long> fakeNow{0};
+static unsigned long fakeClock() { return fakeNow.load(); }
+
+static std::atomic<bool> gate{false};
+static std::atomic<int> blocked{0};
+
+/**
+ * @brief Ocupa um worker até o gate abrir.
+ */
+static void blocker(void *) {
+  blocked.fetch_add(1);
+  while (!gate.load()) std::this_thread::yield();
+}
+
+static std::atomic<int> counter{0};
+static void count(void *) { counter.fetch_add(1); }
+
+/**
+ * @brief Espera todas as tarefas saírem das filas e terminarem.
+ */
+static void drain() {
+  for (bool busy = true; busy;) {
+    busy = false;
+    for (uint8_t i = 0; i < jtaskCapacity; i++) busy |= jtaskPoolPending[i].load();
+    std::this_thread::yield();
+  }
+}
+
+/**
+ * @brief Muda a afinidade de uma tarefa enquanto ela espera na fila, nos dois sentidos.
+ *
+ * Os dois workers ficam presos em tarefas fixadas, então a terceira certamente ainda está na
+ * fila quando jtaskSetAffinity() é chamada.
+ */
+static void testAffinityWhileQueued(int8_t before, int8_t after) {
+  int a = jtaskAttach(blocker, nullptr, 1000);
+  int b = jtaskAttach(blocker, nullptr, 1000);
+  int x = jtaskAttach(count, nullptr, 1000);
+  CHECK(a >= 0 && b >= 0 && x >= 0);
+  jtaskSetAffinity(a, 0);
+  jtaskSetAffinity(b, 1);
+  jtaskSetAffinity(x, before);
+  jtaskSetPriority(a, 0);  // os bloqueadores são despachados antes de x, qualquer que seja o id
+  jtaskSetPriority(b, 0);
+  gate.store(false);
+  blocked.store(0);
+  counter.store(0);
+  fakeNow.fetch_add(1000);
+  jtaskLoop();
+  while (blocked.load() < 2) std::this_thread::yield();
+  CHECK(jtaskPoolPending[x].load());
+  CHECK(jtaskSetAffinity(x, after));
+  gate.store(true);
+  drain();
+  CHECK(counter.load() == 1);
+  CHECK(jtaskPoolStealable.load() == 0);
+  CHECK(jtaskDetach(a) && jtaskDetach(b) && jtaskDetach(x));
+}
+
+/**
+ * @brief Muitas liberações com relógio simulado: tarefas fixadas só rodam no próprio worker.
+ */
+static std::atomic<int> wrongCore{0};
+static void pinned0(void *) {
+  if (std::this_thread::get_id() != jtaskPoolThreads[0].get_id()) wrongCore.fetch_add(1);
+}
+static void pinned1(void *) {
+  if (std::this_thread::get_id() != jtaskPoolThreads[1].get_id()) wrongCore.fetch_add(1);
+}
+
+static void testRun() {
+  int p0 = jtaskAttach(pinned0, nullptr, 100);
+  int p1 = jtaskAttach(pinned1, nullptr, 100);
+  int f[4];
+  for (int i = 0; i < 4; i++) f[i] = jtaskAttach(count, nullptr, 100 * (i + 1));
+  jtaskSetAffinity(p0, 0);
+  jtaskSetAffinity(p1, 1);
+  counter.store(0);
+  for (int step = 0; step < 2000; step++) {
+    fakeNow.fetch_add(100);
+    jtaskLoop();
+    if (step % 97 == 0) jtaskSetAffinity(f[step % 4], (step / 97) % 3 - 1);  // -1, 0 ou 1
+    if (step % 16 == 0) drain();
+  }
+  drain();
+  CHECK(wrongCore.load() == 0);
+  CHECK(jtaskPoolStealable.load() == 0);
+  // Toda liberação foi executada ou contada como perdida.
+  uint32_t releases = 0;
+  for (int i = 0; i < 4; i++) releases += jtaskStats(f[i])->runs - jtaskStats(f[i])->missed;
+  CHECK((uint32_t)counter.load() == releases);
+  printf("execucoes=%d roubos=%u\n", counter.load(), (unsigned)jtaskPoolSteals.load());
+  CHECK(jtaskDetach(p0) && jtaskDetach(p1));
+  for (int i = 0; i < 4; i++) CHECK(jtaskDetach(f[i]));
+}
+
+int main() {
+  jtaskSetClock(fakeClock);
+  CHECK(jtaskSetup(8));
+  CHECK(jtaskPoolBegin());
+  testAffinityWhileQueued(JTASK_ANY_CORE, 0);
+  testAffinityWhileQueued(0, JTASK_ANY_CORE);
+  testRun();
+  jtaskPoolEnd();
+  puts("ok");
+  return 0;
+}
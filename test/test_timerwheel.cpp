@@ -0,0 +1,101 @@
+/**
+ * @file test_timerwheel.cpp
+ * @brief TimerWheel_c com relógio injetado (advance()): nextExpiry() e disparos contra uma referência.
+ */
+
+#include "util/timerWheel.h"
+#include "check.h"
+#include <stdlib.h>
+
+#define TIMERS 48
+
+/**
+ * @brief Caso da revisão: um temporizador ainda no nível 1 vence antes de um do nível 0.
+ */
+static void testUpperLevelFirst() {
+  TimerWheel_c wheel;
+  WheelTimer_c a(wheel), b(wheel);
+  wheel.advance(60);
+  a.start(70); // vence em 130, fica no nível 1
+  wheel.advance(100);
+  b.start(60); // vence em 160, nível 0
+  CHECK(wheel.nextExpiry() == 30);
+  CHECK(wheel.advance(129) == 0);
+  CHECK(wheel.nextExpiry() == 1);
+  CHECK(wheel.advance(130) == 1 && a.isExpired() && !b.isExpired());
+  CHECK(wheel.nextExpiry() == 30);
+  CHECK(wheel.advance(160) == 1 && b.isExpired());
+  CHECK(wheel.nextExpiry() == 0xFFFFFFFF);
+}
+
+/**
+ * @brief Periódico sem deriva e repeat() a partir do vencimento nominal.
+ */
+static void testPeriodic() {
+  TimerWheel_c wheel;
+  WheelTimer_c p(wheel), once(wheel);
+  p.start(7, nullptr, nullptr, true);
+  uint32_t fired = 0;
+  for (uint32_t t = 1; t <= 700; t++) {
+    wheel.advance(t);
+    if (p.isExpired()) {
+      CHECK(t % 7 == 0);
+      fired++;
+    }
+  }
+  CHECK(fired == 100);
+  once.start(10);
+  wheel.advance(715); // atrasado: vence uma vez, em 710
+  CHECK(once.isExpired() && !once.active());
+  once.repeat(); // próximo a partir de 710, não de 715
+  CHECK(once.expires() == 720 && wheel.nextExpiry() <= 5);
+}
+
+/**
+ * @brief Passos aleatórios: nextExpiry() e disparos comparados com o mínimo por força bruta.
+ */
+static void testRandom() {
+  TimerWheel_c wheel;
+  WheelTimer_c *timers[TIMERS];
+  for (int i = 0; i < TIMERS; i++) timers[i] = new WheelTimer_c(wheel);
+  srand(1);
+  uint32_t now = 0;
+  for (int step = 0; step < 200000; step++) {
+    WheelTimer_c *t = timers[rand() % TIMERS];
+    int op = rand() % 8;
+    if (op < 3) {
+      static const uint32_t spans[] = {64, 4096, 262144};
+      t->start(rand() % spans[rand() % 3]);
+    } else if (op == 3) {
+      t->cancel();
+    } else {
+      uint32_t best = 0xFFFFFFFF;
+      for (int i = 0; i < TIMERS; i++)
+        if (timers[i]->active() && timers[i]->expires() - now < best) best = timers[i]->expires() - now;
+      CHECK(wheel.nextExpiry() == best);
+      if (best == 0xFFFFFFFF) {
+        now += rand() % 100;
+        wheel.advance(now);
+        continue;
+      }
+      // Avança até logo antes do próximo vencimento (nada dispara) e então até ele.
+      if (best > 1) CHECK(wheel.advance(now + best - 1) == 0);
+      now += best;
+      uint32_t due = 0;
+      for (int i = 0; i < TIMERS; i++)
+        if (timers[i]->active() && timers[i]->expires() == now) due++;
+      CHECK(wheel.advance(now) == due && due > 0);
+      for (int i = 0; i < TIMERS; i++) timers[i]->isExpired();
+    }
+  }
+  for (int i = 0; i < TIMERS; i++) delete timers[i];
+  CHECK(wheel.count() == 0);
+}
+
+int main() {
+  testUpperLevelFirst();
+  testPeriodic();
+  testRandom();
+  puts("ok");
+  return 0;
+}